@@ -1,11 +1,177 @@
 #include "../boost_algs.h"
-#include <boost/graph/distributed/betweenness_centrality.hpp>
+#include "../mpi_exchange.h"
+#include <dynograph_util/alg_data_manager.h>
+#include <algorithm>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 
-void run_bc(Graph &g)
+/*
+ * Sampled betweenness centrality
+ * Brandes' algorithm, but dependencies are only accumulated from the given sources instead of from every vertex,
+ * so the cost grows with the number of sources instead of the number of vertices.
+ * Centrality is stored in the alg data as a fixed-point number, indexed by global vertex ID.
+ * Each rank only writes the entries for its own vertices.
+ *
+ * Traversals from a group of sources run side by side. Each level of every traversal in the group
+ * goes out in the same exchange, and the frontiers of different traversals are scanned by different threads.
+ */
+
+// Number of sources traversed at the same time, limits the memory used for per-source state
+static const int64_t max_sources_per_pass = 16;
+
+// Path count or dependency sent from a vertex in one traversal to a local vertex
+struct bc_message
+{
+    int64_t source;
+    int64_t vertex;
+    double value;
+};
+
+static int
+get_num_threads()
+{
+#if defined(_OPENMP)
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+static int
+get_thread_id()
+{
+#if defined(_OPENMP)
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+// Combines the messages built by each thread, and sends them to their destinations
+static std::vector<bc_message>
+exchange_messages(boost::mpi::communicator comm, std::vector<std::vector<std::vector<bc_message>>> &thread_outgoing)
 {
-    std::vector<int64_t> local_centrality_vec(boost::num_vertices(g), 0);
-    boost::brandes_betweenness_centrality(
-            g,
-            make_iterator_property_map(local_centrality_vec.begin(), get(boost::vertex_index, g))
-    );
+    std::vector<std::vector<bc_message>> outgoing(comm.size());
+    for (auto& buckets : thread_outgoing)
+    {
+        for (int rank = 0; rank < comm.size(); ++rank)
+        {
+            outgoing[rank].insert(outgoing[rank].end(), buckets[rank].begin(), buckets[rank].end());
+            buckets[rank].clear();
+        }
+    }
+    return exchange(comm, outgoing);
+}
+
+std::vector<double> run_bc(const Graph &g, const std::vector<int64_t> &sources, DynoGraph::Range<int64_t> data)
+{
+    auto comm = boost::mpi::communicator();
+    const auto& dist = g.distribution();
+    const int64_t nv = boost::num_vertices(g);
+    const int num_threads = get_num_threads();
+    auto global_id = [&](int64_t u) { return static_cast<int64_t>(dist.global(comm.rank(), u)); };
+
+    // Dependencies are pushed back against the direction of each edge
+    local_in_edges in_edges = collect_in_edges(g);
+
+    std::vector<double> centrality(nv, 0.0);
+    std::vector<std::vector<std::vector<bc_message>>> thread_outgoing(num_threads,
+        std::vector<std::vector<bc_message>>(comm.size()));
+    for (size_t first = 0; first < sources.size(); first += max_sources_per_pass)
+    {
+        const int64_t num_sources = std::min<int64_t>(max_sources_per_pass, sources.size() - first);
+        // State of each traversal in the group, stored together for each vertex
+        auto at = [&](int64_t s, int64_t u) { return u * num_sources + s; };
+        std::vector<int64_t> depth(nv * num_sources, -1);
+        std::vector<double> num_paths(nv * num_sources, 0.0);
+        std::vector<double> dependency(nv * num_sources, 0.0);
+        // Local vertices at each depth of each traversal
+        std::vector<std::vector<std::vector<int64_t>>> levels(1, std::vector<std::vector<int64_t>>(num_sources));
+        for (int64_t s = 0; s < num_sources; ++s)
+        {
+            int64_t source = sources[first + s];
+            if (static_cast<int>(dist(source)) == comm.rank()) {
+                int64_t u = dist.local(source);
+                depth[at(s, u)] = 0;
+                num_paths[at(s, u)] = 1;
+                levels[0][s].push_back(u);
+            }
+        }
+
+        // Count shortest paths, one level at a time
+        for (int64_t d = 0; ; ++d)
+        {
+            size_t frontier_size = 0;
+            for (const auto& frontier : levels[d]) { frontier_size += frontier.size(); }
+            if (boost::mpi::all_reduce(comm, frontier_size, std::plus<size_t>()) == 0) { break; }
+
+            #pragma omp parallel for schedule(dynamic, 1)
+            for (int64_t s = 0; s < num_sources; ++s)
+            {
+                auto& outgoing = thread_outgoing[get_thread_id()];
+                for (int64_t u : levels[d][s])
+                {
+                    double paths = num_paths[at(s, u)];
+                    BGL_FORALL_OUTEDGES_T(boost::vertex(global_id(u), g), e, g, Graph)
+                    {
+                        BoostVertex v = boost::target(e, g);
+                        outgoing[v.owner].push_back({s, static_cast<int64_t>(v.local), paths});
+                    }
+                }
+            }
+            levels.emplace_back(num_sources);
+            for (const bc_message& m : exchange_messages(comm, thread_outgoing))
+            {
+                int64_t i = at(m.source, m.vertex);
+                if (depth[i] == -1) {
+                    depth[i] = d + 1;
+                    levels[d + 1][m.source].push_back(m.vertex);
+                }
+                if (depth[i] == d + 1) { num_paths[i] += m.value; }
+            }
+        }
+
+        // Accumulate dependencies, from the deepest level back towards the sources
+        // Every rank stopped at the same depth, so they all walk back through the same number of levels
+        for (int64_t d = static_cast<int64_t>(levels.size()) - 1; d > 0; --d)
+        {
+            #pragma omp parallel for schedule(dynamic, 1)
+            for (int64_t s = 0; s < num_sources; ++s)
+            {
+                auto& outgoing = thread_outgoing[get_thread_id()];
+                for (int64_t w : levels[d][s])
+                {
+                    double value = (1 + dependency[at(s, w)]) / num_paths[at(s, w)];
+                    for (int64_t i = in_edges.offsets[w]; i < in_edges.offsets[w+1]; ++i)
+                    {
+                        int64_t v = in_edges.sources[i];
+                        outgoing[dist(v)].push_back({s, static_cast<int64_t>(dist.local(v)), value});
+                    }
+                    DYNOGRAPH_EDGE_COUNT_TRAVERSE_MULTIPLE_EDGES(in_edges.offsets[w+1] - in_edges.offsets[w]);
+                }
+            }
+            for (const bc_message& m : exchange_messages(comm, thread_outgoing))
+            {
+                int64_t i = at(m.source, m.vertex);
+                // Only predecessors on a shortest path get a share of the dependency
+                if (depth[i] == d - 1) { dependency[i] += num_paths[i] * m.value; }
+            }
+        }
+
+        // Sources don't count towards their own centrality
+        for (int64_t u = 0; u < nv; ++u)
+        {
+            for (int64_t s = 0; s < num_sources; ++s)
+            {
+                if (depth[at(s, u)] > 0) { centrality[u] += dependency[at(s, u)]; }
+            }
+        }
+    }
+
+    for (int64_t u = 0; u < nv; ++u)
+    {
+        data[global_id(u)] = DynoGraph::to_fixed_point(centrality[u], DynoGraph::BC_FIXED_POINT_SCALE);
+    }
+    return centrality;
 }
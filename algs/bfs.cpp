@@ -1,34 +1,125 @@
 #include "../boost_algs.h"
-// boost_algs already includes the modified version of bfs header
-//#include "../breadth_first_search.hpp"
+#include "../local_csr.h"
+#include "../mpi_exchange.h"
+#include "out_edges.h"
+#include <algorithm>
 
-template<typename DistanceMap>
-struct bfs_discovery_visitor : boost::bfs_visitor<>
+std::vector<int64_t> run_bfs(const local_csr &csr, const Graph &g, int64_t source)
 {
-    bfs_discovery_visitor(DistanceMap distance) : distance(distance)
+    auto comm = boost::mpi::communicator();
+    const auto& dist = g.distribution();
+    std::vector<int64_t> distance(csr.num_local_vertices(), -1);
+
+    // Level-synchronous traversal, the frontier holds local vertex indices
+    std::vector<int64_t> frontier;
+    if (static_cast<int>(dist(source)) == comm.rank()) {
+        int64_t s = dist.local(source);
+        distance[s] = 0;
+        frontier.push_back(s);
+    }
+    for (int64_t level = 1; boost::mpi::all_reduce(comm, frontier.size(), std::plus<size_t>()) > 0; ++level)
     {
-        boost::set_property_map_role(boost::vertex_distance, distance);
+        // Send each neighbor of the frontier to the rank that owns it
+        std::vector<std::vector<int64_t>> outgoing(comm.size());
+        for (int64_t u : frontier)
+        {
+            for (int64_t i = csr.offsets[u]; i < csr.offsets[u+1]; ++i)
+            {
+                int64_t v = csr.targets[i];
+                outgoing[dist(v)].push_back(dist.local(v));
+            }
+            DYNOGRAPH_EDGE_COUNT_TRAVERSE_MULTIPLE_EDGES(csr.out_degree(u));
+        }
+        // Visit neighbors that haven't been discovered yet
+        frontier.clear();
+        for (int64_t v : exchange(comm, outgoing))
+        {
+            if (distance[v] == -1) {
+                distance[v] = level;
+                frontier.push_back(v);
+            }
+        }
     }
+    return distance;
+}
+
+// Sources whose traversals reached a local vertex in the same level, one bit per source
+struct source_mask_update
+{
+    int64_t vertex;
+    uint64_t mask;
+};
+
+/*
+ * Multi-source BFS
+ * Runs the traversals from up to 64 sources at the same time. Each vertex has one visited bit per source,
+ * and the bits that reach a vertex in the same level travel together, so each edge is scanned once per level
+ * for all sources, instead of once for each source.
+ * The alg data holds the mask of sources that reach each vertex, indexed by global vertex ID.
+ * Each rank only writes the entries for its own vertices.
+ */
+template<typename OutEdges>
+static std::vector<uint64_t>
+run_multi_source_bfs(const OutEdges& out_edges, const Graph& g, const std::vector<int64_t>& sources,
+    DynoGraph::Range<int64_t> data)
+{
+    auto comm = boost::mpi::communicator();
+    const auto& dist = g.distribution();
+    const int64_t nv = out_edges.num_local_vertices();
+    const size_t num_sources = std::min<size_t>(sources.size(), 64);
 
-    template<typename Edge, typename Graph>
-    void tree_edge(Edge e, const Graph& g)
+    // Sources that reached each vertex so far, and in the current level
+    std::vector<uint64_t> visited(nv, 0);
+    std::vector<uint64_t> frontier_mask(nv, 0);
+    std::vector<int64_t> frontier;
+    for (size_t i = 0; i < num_sources; ++i)
     {
-        std::size_t new_distance = get(distance, boost::source(e, g)) + 1;
-        put(distance, boost::target(e, g), new_distance);
+        if (static_cast<int>(dist(sources[i])) != comm.rank()) { continue; }
+        int64_t s = dist.local(sources[i]);
+        if (frontier_mask[s] == 0) { frontier.push_back(s); }
+        visited[s] |= uint64_t(1) << i;
+        frontier_mask[s] |= uint64_t(1) << i;
     }
 
-private:
-    DistanceMap distance;
-};
+    while (boost::mpi::all_reduce(comm, frontier.size(), std::plus<size_t>()) > 0)
+    {
+        // Send the bits of the frontier to the owner of each neighbor
+        std::vector<std::vector<source_mask_update>> outgoing(comm.size());
+        for (int64_t u : frontier)
+        {
+            uint64_t mask = frontier_mask[u];
+            frontier_mask[u] = 0;
+            out_edges.for_each_target(u, [&](int64_t v) {
+                outgoing[dist(v)].push_back({static_cast<int64_t>(dist.local(v)), mask});
+            });
+        }
+        // Keep the bits of sources that haven't reached the neighbor yet
+        frontier.clear();
+        for (const source_mask_update& update : exchange(comm, outgoing))
+        {
+            uint64_t new_bits = update.mask & ~visited[update.vertex];
+            if (new_bits == 0) { continue; }
+            if (frontier_mask[update.vertex] == 0) { frontier.push_back(update.vertex); }
+            visited[update.vertex] |= new_bits;
+            frontier_mask[update.vertex] |= new_bits;
+        }
+    }
+
+    for (int64_t u = 0; u < nv; ++u)
+    {
+        data[dist.global(comm.rank(), u)] = static_cast<int64_t>(visited[u]);
+    }
+    return visited;
+}
+
+std::vector<uint64_t> run_multi_source_bfs(const Graph &g, const std::vector<int64_t> &sources,
+    DynoGraph::Range<int64_t> data)
+{
+    return run_multi_source_bfs(graph_out_edges{g, process_id(g.process_group())}, g, sources, data);
+}
 
-void run_bfs(Graph &g, BoostVertex source)
+std::vector<uint64_t> run_multi_source_bfs(const local_csr &csr, const Graph &g, const std::vector<int64_t> &sources,
+    DynoGraph::Range<int64_t> data)
 {
-    std::vector<int> local_distance_vec(boost::num_vertices(g));
-    auto distance_map = make_iterator_property_map(local_distance_vec.begin(), get(boost::vertex_index, g));
-    bfs_discovery_visitor<decltype(distance_map)> visitor(distance_map);
-    breadth_first_search(
-            g,
-            source,
-            boost::visitor(visitor)
-    );
-}
\ No newline at end of file
+    return run_multi_source_bfs(csr_out_edges{csr}, g, sources, data);
+}
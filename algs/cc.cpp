@@ -1,13 +1,178 @@
 #include "../boost_algs.h"
-#include <boost/graph/distributed/connected_components_parallel_search.hpp>
-#include <boost/graph/strong_components.hpp>
-#include <boost/graph/distributed/strong_components.hpp>
+#include "../mpi_exchange.h"
+#include <algorithm>
+#include <unordered_map>
 
-void run_cc(Graph &g)
+/*
+ * Weakly connected components
+ * Each component is labeled with the smallest vertex ID in it, plus one.
+ * Labels are stored in the alg data, indexed by global vertex ID.
+ * Each rank only reads and writes the entries for its own vertices, and zero means there is no previous result.
+ */
+
+// New label for a local vertex
+struct label_update
+{
+    int64_t vertex;
+    int64_t label;
+};
+
+void run_cc(Graph &g, DynoGraph::Range<int64_t> data)
 {
-    std::vector<int> local_components_vec(boost::num_vertices(g));
-    boost::graph::connected_components(
-        g,
-        make_iterator_property_map(local_components_vec.begin(), get(boost::vertex_index, g))
-    );
+    auto comm = boost::mpi::communicator();
+    const auto& dist = g.distribution();
+    const int64_t nv = boost::num_vertices(g);
+
+    // Labels have to travel against the direction of each edge too
+    local_in_edges in_edges = collect_in_edges(g);
+    const std::vector<int64_t>& in_offsets = in_edges.offsets;
+
+    // Start with each vertex in its own component
+    std::vector<int64_t> labels(nv);
+    std::vector<int64_t> frontier(nv);
+    for (int64_t u = 0; u < nv; ++u)
+    {
+        labels[u] = dist.global(comm.rank(), u) + 1;
+        frontier[u] = u;
+    }
+
+    // Propagate the smallest label in both directions along each edge, until no labels change
+    // PBGL's connected_components only follows out-edges, which doesn't work for a directed graph
+    while (boost::mpi::all_reduce(comm, frontier.size(), std::plus<size_t>()) > 0)
+    {
+        std::vector<std::vector<label_update>> outgoing(comm.size());
+        auto send = [&](int64_t v, int64_t label) {
+            outgoing[dist(v)].push_back({static_cast<int64_t>(dist.local(v)), label});
+        };
+        for (int64_t u : frontier)
+        {
+            BoostVertex v = boost::vertex(dist.global(comm.rank(), u), g);
+            BGL_FORALL_OUTEDGES_T(v, e, g, Graph) { send(get_global_id(g, boost::target(e, g)), labels[u]); }
+            for (int64_t i = in_offsets[u]; i < in_offsets[u+1]; ++i) { send(in_edges.sources[i], labels[u]); }
+            DYNOGRAPH_EDGE_COUNT_TRAVERSE_MULTIPLE_EDGES(in_offsets[u+1] - in_offsets[u]);
+        }
+        frontier.clear();
+        for (const label_update& update : exchange(comm, outgoing))
+        {
+            if (update.label < labels[update.vertex]) {
+                labels[update.vertex] = update.label;
+                frontier.push_back(update.vertex);
+            }
+        }
+        // A vertex may get a smaller label more than once in the same round
+        std::sort(frontier.begin(), frontier.end());
+        frontier.erase(std::unique(frontier.begin(), frontier.end()), frontier.end());
+    }
+
+    for (int64_t u = 0; u < nv; ++u)
+    {
+        data[dist.global(comm.rank(), u)] = labels[u];
+    }
+}
+
+// Two component labels that are joined by a new edge
+struct label_pair
+{
+    int64_t a;
+    int64_t b;
+};
+
+// Union-find over component labels, the smallest label in each set is the root
+struct label_forest
+{
+    std::unordered_map<int64_t, int64_t> parent;
+
+    int64_t find(int64_t x)
+    {
+        auto it = parent.find(x);
+        while (it != parent.end() && it->second != x)
+        {
+            // Path halving
+            auto grandparent = parent.find(it->second);
+            it->second = grandparent->second;
+            x = it->second;
+            it = parent.find(x);
+        }
+        return x;
+    }
+
+    void merge(int64_t a, int64_t b)
+    {
+        parent.emplace(a, a);
+        parent.emplace(b, b);
+        a = find(a);
+        b = find(b);
+        if (a < b) { parent[b] = a; } else if (b < a) { parent[a] = b; }
+    }
+};
+
+bool run_incremental_cc(const Graph &g, const std::vector<std::pair<int64_t, int64_t>> &new_edges,
+    DynoGraph::Range<int64_t> data)
+{
+    auto comm = boost::mpi::communicator();
+    const auto& dist = g.distribution();
+    const int64_t nv = boost::num_vertices(g);
+
+    // Every vertex has a label after a full run, so give up if any of them is missing
+    int missing = 0;
+    for (int64_t u = 0; u < nv; ++u)
+    {
+        if (data[dist.global(comm.rank(), u)] == 0) { missing = 1; break; }
+    }
+    if (boost::mpi::all_reduce(comm, missing, boost::mpi::maximum<int>())) { return false; }
+
+    // Ask the owner of the destination of each new edge for its label
+    // Replies come back in the same order as the queries, grouped by rank
+    std::vector<int64_t> rank_query_counts(comm.size(), 0);
+    for (const auto& e : new_edges) { rank_query_counts[dist(e.second)] += 1; }
+    std::vector<int> query_counts = checked_counts(comm, rank_query_counts);
+    std::vector<int64_t> queries(new_edges.size());
+    std::vector<int64_t> offsets(comm.size(), 0);
+    std::partial_sum(query_counts.begin(), query_counts.end() - 1, offsets.begin() + 1);
+    std::vector<int64_t> query_index(new_edges.size());
+    for (size_t i = 0; i < new_edges.size(); ++i)
+    {
+        query_index[i] = offsets[dist(new_edges[i].second)]++;
+        queries[query_index[i]] = new_edges[i].second;
+    }
+    std::vector<int64_t> received_queries;
+    std::vector<int> reply_counts = exchange(comm, queries.data(), query_counts, received_queries);
+    for (int64_t& id : received_queries) { id = data[id]; }
+    std::vector<int64_t> dst_labels;
+    exchange(comm, received_queries.data(), reply_counts, dst_labels);
+    DYNOGRAPH_EDGE_COUNT_TRAVERSE_MULTIPLE_EDGES(new_edges.size());
+
+    // Merge the labels joined by the new edges on this rank first, so each rank only shares one pair
+    // per label that changed, instead of one per new edge
+    label_forest local_forest;
+    for (size_t i = 0; i < new_edges.size(); ++i)
+    {
+        int64_t a = data[new_edges[i].first];
+        int64_t b = dst_labels[query_index[i]];
+        if (a != b) { local_forest.merge(a, b); }
+    }
+    std::vector<label_pair> local_merges;
+    for (const auto& p : local_forest.parent)
+    {
+        int64_t root = local_forest.find(p.first);
+        if (root != p.first) { local_merges.push_back({p.first, root}); }
+    }
+    std::vector<std::vector<label_pair>> outgoing(comm.size(), local_merges);
+    std::vector<label_pair> merges = exchange(comm, outgoing);
+
+    // Union-find over the labels, the smallest label in each merged set becomes the root,
+    // so the labels are the same as after a full run
+    label_forest forest;
+    for (const label_pair& m : merges) { forest.merge(m.a, m.b); }
+
+    // Relabel the local vertices in components that were merged
+    if (!forest.parent.empty())
+    {
+        for (int64_t u = 0; u < nv; ++u)
+        {
+            int64_t& label = data[dist.global(comm.rank(), u)];
+            if (forest.parent.count(label)) { label = forest.find(label); }
+        }
+    }
+    return true;
 }
@@ -0,0 +1,172 @@
+#include "../boost_algs.h"
+#include "../mpi_exchange.h"
+#include <algorithm>
+#include <limits>
+
+/*
+ * Incremental BFS/SSSP
+ * Distances are stored in the alg data, indexed by global vertex ID, with -1 for unreached vertices.
+ * Each rank only reads and writes the entries for its own vertices.
+ *
+ * The previous shortest-path tree is repaired instead of recomputed:
+ * 1. Vertices whose tree edge was removed lose their distance, along with everything below them in the tree
+ * 2. In-neighbors of the invalidated part of the tree that still have a distance are added to the frontier
+ * 3. Sources of inserted edges are added to the frontier, since they may offer shorter paths
+ * 4. Distances are relaxed from the frontier until they stop changing
+ * Every other vertex keeps its distance, so the work is proportional to the part of the tree that changed.
+ */
+
+static const int64_t UNREACHED = std::numeric_limits<int64_t>::max();
+
+// Offers a new distance to a local vertex
+struct distance_update
+{
+    int64_t vertex;
+    int64_t distance;
+    int64_t parent;
+};
+
+// Tells a local vertex that the edge from parent is gone, or that parent lost its distance
+struct parent_check
+{
+    int64_t vertex;
+    int64_t parent;
+};
+
+// Removes duplicates from a list of local vertices
+static void
+sort_and_unique(std::vector<int64_t> &vertices)
+{
+    std::sort(vertices.begin(), vertices.end());
+    vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+}
+
+traversal_tree run_incremental_traversal(const Graph &g, int64_t source, bool weighted,
+    const traversal_tree *previous,
+    const std::vector<std::pair<int64_t, int64_t>> &inserted_edges,
+    const std::vector<std::pair<int64_t, int64_t>> &removed_edges,
+    DynoGraph::Range<int64_t> data)
+{
+    auto comm = boost::mpi::communicator();
+    const auto& dist = g.distribution();
+    const int64_t nv = boost::num_vertices(g);
+    auto global_id = [&](int64_t u) { return static_cast<int64_t>(dist.global(comm.rank(), u)); };
+
+    traversal_tree tree;
+    tree.source = source;
+    tree.parents.assign(nv, -1);
+    std::vector<int64_t> distances(nv, UNREACHED);
+    std::vector<int64_t> frontier;
+
+    if (previous && previous->source == source && static_cast<int64_t>(previous->parents.size()) == nv)
+    {
+        // Start from the previous tree
+        tree.parents = previous->parents;
+        for (int64_t u = 0; u < nv; ++u)
+        {
+            int64_t d = data[global_id(u)];
+            distances[u] = d < 0 ? UNREACHED : d;
+        }
+
+        // 1. Invalidate the subtrees below removed tree edges
+        std::vector<std::vector<parent_check>> checks(comm.size());
+        for (const auto& e : removed_edges)
+        {
+            checks[dist(e.second)].push_back({static_cast<int64_t>(dist.local(e.second)), e.first});
+        }
+        std::vector<int64_t> invalidated;
+        size_t num_checks = 0;
+        for (const auto& bucket : checks) { num_checks += bucket.size(); }
+        while (boost::mpi::all_reduce(comm, num_checks, std::plus<size_t>()) > 0)
+        {
+            std::vector<int64_t> newly_invalidated;
+            for (const parent_check& c : exchange(comm, checks))
+            {
+                if (distances[c.vertex] != UNREACHED && tree.parents[c.vertex] == c.parent) {
+                    distances[c.vertex] = UNREACHED;
+                    tree.parents[c.vertex] = -1;
+                    newly_invalidated.push_back(c.vertex);
+                }
+            }
+            // Children of an invalidated vertex are found among its out-neighbors
+            for (auto& bucket : checks) { bucket.clear(); }
+            num_checks = 0;
+            for (int64_t u : newly_invalidated)
+            {
+                BGL_FORALL_OUTEDGES_T(boost::vertex(global_id(u), g), e, g, Graph)
+                {
+                    BoostVertex v = boost::target(e, g);
+                    checks[v.owner].push_back({static_cast<int64_t>(v.local), global_id(u)});
+                    num_checks += 1;
+                }
+            }
+            invalidated.insert(invalidated.end(), newly_invalidated.begin(), newly_invalidated.end());
+        }
+
+        // 2. Reattach the invalidated vertices through edges from the rest of the tree
+        // Each invalidated vertex asks its in-neighbors to join the frontier, only the ones that kept a distance do
+        if (boost::mpi::all_reduce(comm, invalidated.size(), std::plus<size_t>()) > 0)
+        {
+            local_in_edges in_edges = collect_in_edges(g);
+            std::vector<std::vector<int64_t>> requests(comm.size());
+            for (int64_t u : invalidated)
+            {
+                for (int64_t i = in_edges.offsets[u]; i < in_edges.offsets[u+1]; ++i)
+                {
+                    int64_t w = in_edges.sources[i];
+                    requests[dist(w)].push_back(dist.local(w));
+                }
+            }
+            for (int64_t w : exchange(comm, requests))
+            {
+                if (distances[w] != UNREACHED) { frontier.push_back(w); }
+            }
+        }
+
+        // 3. Sources of inserted edges may offer shorter paths
+        for (const auto& e : inserted_edges)
+        {
+            int64_t u = dist.local(e.first);
+            if (distances[u] != UNREACHED) { frontier.push_back(u); }
+        }
+    } else {
+        // No tree to repair, start from the source
+        if (static_cast<int>(dist(source)) == comm.rank()) {
+            int64_t s = dist.local(source);
+            distances[s] = 0;
+            frontier.push_back(s);
+        }
+    }
+    sort_and_unique(frontier);
+
+    // 4. Relax the out-edges of the frontier until no distances change
+    while (boost::mpi::all_reduce(comm, frontier.size(), std::plus<size_t>()) > 0)
+    {
+        std::vector<std::vector<distance_update>> outgoing(comm.size());
+        for (int64_t u : frontier)
+        {
+            BGL_FORALL_OUTEDGES_T(boost::vertex(global_id(u), g), e, g, Graph)
+            {
+                int64_t weight = weighted ? get(boost::edge_weight, g, e) : 1;
+                BoostVertex v = boost::target(e, g);
+                outgoing[v.owner].push_back({static_cast<int64_t>(v.local), distances[u] + weight, global_id(u)});
+            }
+        }
+        frontier.clear();
+        for (const distance_update& update : exchange(comm, outgoing))
+        {
+            if (update.distance < distances[update.vertex]) {
+                distances[update.vertex] = update.distance;
+                tree.parents[update.vertex] = update.parent;
+                frontier.push_back(update.vertex);
+            }
+        }
+        sort_and_unique(frontier);
+    }
+
+    for (int64_t u = 0; u < nv; ++u)
+    {
+        data[global_id(u)] = distances[u] == UNREACHED ? -1 : distances[u];
+    }
+    return tree;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "../boost_algs.h"
+#include "../local_csr.h"
+
+/*
+ * Adapters that let a traversal run on either the adjacency list or the CSR snapshot
+ * Local vertices are numbered 0 to num_local_vertices()-1, targets are global vertex IDs
+ */
+
+// Out-edges of the local vertices of the adjacency list
+struct graph_out_edges
+{
+    const Graph& g;
+    int rank;
+    int64_t num_local_vertices() const { return static_cast<int64_t>(boost::num_vertices(g)); }
+    BoostVertex vertex(int64_t u) const { return boost::vertex(g.distribution().global(rank, u), g); }
+    int64_t out_degree(int64_t u) const { return boost::out_degree(vertex(u), g); }
+    template<typename Visitor>
+    void for_each_target(int64_t u, Visitor visit) const
+    {
+        BGL_FORALL_OUTEDGES_T(vertex(u), e, g, Graph)
+        {
+            visit(get_global_id(g, boost::target(e, g)));
+        }
+    }
+};
+
+// Out-edges of the local vertices of the CSR snapshot
+struct csr_out_edges
+{
+    const local_csr& csr;
+    int64_t num_local_vertices() const { return csr.num_local_vertices(); }
+    int64_t out_degree(int64_t u) const { return csr.out_degree(u); }
+    template<typename Visitor>
+    void for_each_target(int64_t u, Visitor visit) const
+    {
+        for (int64_t i = csr.offsets[u]; i < csr.offsets[u+1]; ++i) { visit(csr.targets[i]); }
+        DYNOGRAPH_EDGE_COUNT_TRAVERSE_MULTIPLE_EDGES(csr.out_degree(u));
+    }
+};
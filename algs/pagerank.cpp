@@ -1,17 +1,167 @@
 #include "../boost_algs.h"
-#include <boost/graph/distributed/page_rank.hpp>
+#include "../mpi_exchange.h"
+#include "out_edges.h"
+#include <dynograph_util/alg_data_manager.h>
+#include <algorithm>
+#include <cmath>
 
-void run_pagerank(Graph &g)
+// Rank contributed to a local vertex by one of its in-edges
+struct rank_contribution
 {
-    std::vector<double> vertexRanks(num_vertices(g));
-    std::vector<double> vertexRanks2(num_vertices(g));
-
-    boost::graph::distributed::page_rank(
-        g,
-        make_iterator_property_map(vertexRanks.begin(), get(boost::vertex_index, g)),
-        boost::graph::n_iterations(20),
-        0.85,
-        boost::num_vertices(g),
-        make_iterator_property_map(vertexRanks2.begin(), get(boost::vertex_index, g))
-    );
+    int64_t vertex;
+    double value;
+};
+
+// Returns the total change in rank that is small enough to stop iterating
+// Can be overridden with BOOST_DYNOGRAPH_PAGERANK_TOLERANCE
+static double
+get_pagerank_tolerance()
+{
+    const char* value = getenv("BOOST_DYNOGRAPH_PAGERANK_TOLERANCE");
+    return value ? atof(value) : 1e-3;
+}
+
+/*
+ * Incremental PageRank
+ * The alg data holds the rank of each vertex from the previous epoch, as a fixed-point number.
+ * Each rank only reads and writes the entries for its own vertices.
+ * Vertices without a previous rank (zero) start at 1/n, so the first epoch is a cold start.
+ *
+ * Instead of a fixed number of sweeps over every edge, this tracks the residual of each vertex,
+ * i.e. how far it is from satisfying the PageRank equation. One sweep computes the residuals
+ * against the previous ranks, then only vertices with a large residual push it to their neighbors.
+ * When the graph changed a little since the last epoch, few vertices stay active after the first round.
+ *
+ * If the ranks and residuals from the previous epoch on the same graph are available, and edges were only added,
+ * the full sweep is skipped: only the sources of new edges send the change in their contributions.
+ */
+template<typename OutEdges>
+static pagerank_state
+run_residual_pagerank(const OutEdges& out_edges, const Graph& g, const pagerank_state *previous,
+    const std::vector<std::pair<int64_t, int64_t>> &new_edges, DynoGraph::Range<int64_t> data)
+{
+    auto comm = boost::mpi::communicator();
+    const auto& dist = g.distribution();
+    const double damping = 0.85;
+    const int max_num_rounds = 100;
+    const int64_t nv = out_edges.num_local_vertices();
+    const double n = static_cast<double>(boost::mpi::all_reduce(comm, nv, std::plus<int64_t>()));
+    // Vertices stop pushing once their residual is small enough that the total change stays within tolerance
+    const double threshold = get_pagerank_tolerance() * (1 - damping) / n;
+
+    // Every rank has to agree on whether to do the full sweep
+    int has_previous = previous && static_cast<int64_t>(previous->ranks.size()) == nv
+        && static_cast<int64_t>(previous->residuals.size()) == nv;
+    has_previous = boost::mpi::all_reduce(comm, has_previous, boost::mpi::minimum<int>());
+
+    // Sends damping * value / degree along each out-edge of u
+    std::vector<std::vector<rank_contribution>> outgoing(comm.size());
+    auto push = [&](int64_t u, double value)
+    {
+        int64_t degree = out_edges.out_degree(u);
+        if (degree == 0) { return; }
+        double contribution = damping * value / degree;
+        out_edges.for_each_target(u, [&](int64_t v) {
+            outgoing[dist(v)].push_back({static_cast<int64_t>(dist.local(v)), contribution});
+        });
+    };
+    auto receive = [&](std::vector<double>& sums)
+    {
+        for (const rank_contribution& c : exchange(comm, outgoing)) { sums[c.vertex] += c.value; }
+        for (auto& bucket : outgoing) { bucket.clear(); }
+    };
+
+    pagerank_state state;
+    std::vector<double>& ranks = state.ranks;
+    std::vector<double>& residuals = state.residuals;
+    if (has_previous)
+    {
+        // Continue from the previous ranks and residuals
+        state = *previous;
+        // A source with new edges splits its rank between more targets, so each of its old targets
+        // loses some of the contribution it had before, and each new target gets a full share
+        std::vector<std::pair<int64_t, int64_t>> sorted_edges(new_edges);
+        std::sort(sorted_edges.begin(), sorted_edges.end());
+        for (auto first = sorted_edges.begin(); first != sorted_edges.end();)
+        {
+            const int64_t src = first->first;
+            auto last = std::find_if(first, sorted_edges.end(),
+                [&](const std::pair<int64_t, int64_t>& e) { return e.first != src; });
+            int64_t u = dist.local(src);
+            int64_t degree = out_edges.out_degree(u);
+            int64_t old_degree = degree - (last - first);
+            out_edges.for_each_target(u, [&](int64_t v) {
+                double contribution = damping * ranks[u] / degree;
+                if (!std::binary_search(first, last, std::make_pair(src, v))) {
+                    contribution -= damping * ranks[u] / old_degree;
+                }
+                outgoing[dist(v)].push_back({static_cast<int64_t>(dist.local(v)), contribution});
+            });
+            first = last;
+        }
+        receive(residuals);
+    } else {
+        // Warm start from the ranks in the alg data
+        ranks.assign(nv, 1.0 / n);
+        for (int64_t u = 0; u < nv; ++u)
+        {
+            double rank = DynoGraph::from_fixed_point(data[dist.global(comm.rank(), u)],
+                DynoGraph::PAGERANK_FIXED_POINT_SCALE);
+            if (rank > 0) { ranks[u] = rank; }
+        }
+
+        // Compute the residual of each vertex with one full sweep
+        residuals.assign(nv, 0.0);
+        for (int64_t u = 0; u < nv; ++u) { push(u, ranks[u]); }
+        receive(residuals);
+        for (int64_t v = 0; v < nv; ++v)
+        {
+            residuals[v] += (1 - damping) / n - ranks[v];
+        }
+    }
+
+    // Push residuals from active vertices until they all fall below the threshold
+    for (int round = 0; round < max_num_rounds; ++round)
+    {
+        int64_t num_active = 0;
+        for (int64_t u = 0; u < nv; ++u)
+        {
+            if (std::fabs(residuals[u]) <= threshold) { continue; }
+            ranks[u] += residuals[u];
+            push(u, residuals[u]);
+            residuals[u] = 0;
+            num_active += 1;
+        }
+        if (boost::mpi::all_reduce(comm, num_active, std::plus<int64_t>()) == 0) { break; }
+        receive(residuals);
+    }
+
+    // Save the ranks for the next epoch
+    for (int64_t u = 0; u < nv; ++u)
+    {
+        data[dist.global(comm.rank(), u)] = DynoGraph::to_fixed_point(ranks[u], DynoGraph::PAGERANK_FIXED_POINT_SCALE);
+    }
+    return state;
+}
+
+std::vector<double> run_pagerank(Graph &g, DynoGraph::Range<int64_t> data)
+{
+    return run_residual_pagerank(graph_out_edges{g, process_id(g.process_group())}, g, nullptr, {}, data).ranks;
+}
+
+std::vector<double> run_pagerank(const local_csr &csr, const Graph &g, DynoGraph::Range<int64_t> data)
+{
+    return run_residual_pagerank(csr_out_edges{csr}, g, nullptr, {}, data).ranks;
+}
+
+pagerank_state run_incremental_pagerank(const Graph &g, const pagerank_state *previous,
+    const std::vector<std::pair<int64_t, int64_t>> &new_edges, DynoGraph::Range<int64_t> data)
+{
+    return run_residual_pagerank(graph_out_edges{g, process_id(g.process_group())}, g, previous, new_edges, data);
+}
+
+pagerank_state run_incremental_pagerank(const local_csr &csr, const Graph &g, const pagerank_state *previous,
+    const std::vector<std::pair<int64_t, int64_t>> &new_edges, DynoGraph::Range<int64_t> data)
+{
+    return run_residual_pagerank(csr_out_edges{csr}, g, previous, new_edges, data);
 }
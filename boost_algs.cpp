@@ -3,17 +3,58 @@
 //
 
 #include "boost_algs.h"
+#include "local_csr.h"
+#include "mpi_exchange.h"
+#include <algorithm>
+#include <numeric>
 
 using std::string;
 using std::cerr;
 
-void runAlgorithm(string algName, Graph &g, const std::vector<int64_t> &sources)
+// Edge from a vertex on another rank to a local vertex
+struct reverse_edge
 {
-    if      (algName == "bc")  { run_bc(g);  }
-    else if (algName == "bfs") { run_bfs(g, boost::vertex(sources[0], g)); }
-    else if (algName == "cc")  { run_cc(g); }
+    int64_t target;
+    int64_t source;
+};
+
+local_in_edges collect_in_edges(const Graph &g)
+{
+    auto comm = boost::mpi::communicator();
+    const int64_t nv = boost::num_vertices(g);
+    std::vector<std::vector<reverse_edge>> outgoing_edges(comm.size());
+    BGL_FORALL_VERTICES_T(v, g, Graph)
+    {
+        int64_t source = get_global_id(g, v);
+        BGL_FORALL_OUTEDGES_T(v, e, g, Graph)
+        {
+            BoostVertex target = boost::target(e, g);
+            outgoing_edges[target.owner].push_back({static_cast<int64_t>(target.local), source});
+        }
+    }
+    std::vector<reverse_edge> edges = exchange(comm, outgoing_edges);
+    std::sort(edges.begin(), edges.end(),
+        [](const reverse_edge& a, const reverse_edge& b) { return a.target < b.target; });
+
+    local_in_edges in_edges;
+    in_edges.offsets.assign(nv + 1, 0);
+    in_edges.sources.resize(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        in_edges.offsets[edges[i].target + 1] += 1;
+        in_edges.sources[i] = edges[i].source;
+    }
+    std::partial_sum(in_edges.offsets.begin(), in_edges.offsets.end(), in_edges.offsets.begin());
+    return in_edges;
+}
+
+void runAlgorithm(string algName, Graph &g, const std::vector<int64_t> &sources, DynoGraph::Range<int64_t> data)
+{
+    if      (algName == "bc")  { run_bc(g, sources, data); }
+    else if (algName == "bfs") { run_multi_source_bfs(g, sources, data); }
+    else if (algName == "cc")  { run_cc(g, data); }
     else if (algName == "gc")  { run_gc(g); }
-    else if (algName == "pagerank") { run_pagerank(g); }
+    else if (algName == "pagerank") { run_pagerank(g, data); }
     else if (algName == "sssp"){ run_sssp(g, boost::vertex(sources[0], g)); }
     else
     {
@@ -22,3 +63,12 @@ void runAlgorithm(string algName, Graph &g, const std::vector<int64_t> &sources)
     }
     synchronize(g);
 }
+
+bool runAlgorithm(string algName, const local_csr &csr, const Graph &g, const std::vector<int64_t> &sources,
+    DynoGraph::Range<int64_t> data)
+{
+    if      (algName == "bfs") { run_multi_source_bfs(csr, g, sources, data); }
+    else if (algName == "pagerank") { run_pagerank(csr, g, data); }
+    else { return false; }
+    return true;
+}
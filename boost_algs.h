@@ -10,17 +10,84 @@
 #include "breadth_first_search.hpp"
 
 #include "graph_config.h"
+#include <dynograph_util/range.h>
 #include <string>
+#include <vector>
+#include <utility>
 #include <inttypes.h>
 
-void runAlgorithm(std::string algName, Graph &g, const std::vector<int64_t> &sources);
+class local_csr;
 
-void run_bc(Graph &g);
-void run_bfs(Graph &g, BoostVertex source);
-void run_cc(Graph &g);
+// Converts a vertex descriptor (owner, local index) back into a global vertex ID
+inline BoostVertexId
+get_global_id(const Graph& g, BoostVertex v)
+{
+    return g.distribution().global(v.owner, v.local);
+}
+
+// Sources of the in-edges of each local vertex, collected from the owners of the sources (collective)
+// The graph's own in-edge lists can't be used, because removing edges sometimes drops the wrong in-edge
+struct local_in_edges
+{
+    // The sources of the in-edges of local vertex u are sources[offsets[u]] to sources[offsets[u+1]-1]
+    std::vector<int64_t> offsets;
+    std::vector<int64_t> sources;
+};
+local_in_edges collect_in_edges(const Graph &g);
+
+void runAlgorithm(std::string algName, Graph &g, const std::vector<int64_t> &sources, DynoGraph::Range<int64_t> data);
+// Runs the algorithm on the CSR snapshot, returns false if there is no CSR version of the algorithm
+bool runAlgorithm(std::string algName, const local_csr &csr, const Graph &g, const std::vector<int64_t> &sources,
+    DynoGraph::Range<int64_t> data);
+
+// Betweenness centrality accumulated from the given sources only, written into data as a fixed-point number
+std::vector<double> run_bc(const Graph &g, const std::vector<int64_t> &sources, DynoGraph::Range<int64_t> data);
+// Traverses from up to 64 sources at once, data gets the mask of sources that reach each vertex
+std::vector<uint64_t> run_multi_source_bfs(const Graph &g, const std::vector<int64_t> &sources,
+    DynoGraph::Range<int64_t> data);
 void run_gc(Graph &g);
 void run_sssp(Graph &g, BoostVertex source);
-void run_pagerank(Graph &g);
+// Incremental algorithms read the previous epoch's results from data, and write the new results back
+std::vector<double> run_pagerank(Graph &g, DynoGraph::Range<int64_t> data);
+void run_cc(Graph &g, DynoGraph::Range<int64_t> data);
+// Ranks and residuals kept between epochs, so PageRank only has to push the changes from new edges
+struct pagerank_state
+{
+    std::vector<double> ranks;
+    std::vector<double> residuals;
+};
+// Continues from previous if it is given, otherwise starts from the ranks in data (collective)
+// New edges are listed on the rank that owns their source, and must be the only change since previous
+pagerank_state run_incremental_pagerank(const Graph &g, const pagerank_state *previous,
+    const std::vector<std::pair<int64_t, int64_t>> &new_edges, DynoGraph::Range<int64_t> data);
+pagerank_state run_incremental_pagerank(const local_csr &csr, const Graph &g, const pagerank_state *previous,
+    const std::vector<std::pair<int64_t, int64_t>> &new_edges, DynoGraph::Range<int64_t> data);
+// Updates the previous component labels with the edges added since then (collective)
+// Returns false if there are no previous labels to update
+bool run_incremental_cc(const Graph &g, const std::vector<std::pair<int64_t, int64_t>> &new_edges,
+    DynoGraph::Range<int64_t> data);
+
+// Shortest-path tree from a single source, kept between epochs so SSSP can be repaired
+struct traversal_tree
+{
+    int64_t source;
+    // Parent of each local vertex in the tree, -1 for the source and unreached vertices
+    std::vector<int64_t> parents;
+};
+// Computes hop counts (or weighted distances) from source into data, -1 for unreached vertices (collective)
+// If previous has the same source, only the parts of it affected by the inserted and removed edges are recomputed
+// Edges are listed on the rank that owns their source
+traversal_tree run_incremental_traversal(const Graph &g, int64_t source, bool weighted,
+    const traversal_tree *previous,
+    const std::vector<std::pair<int64_t, int64_t>> &inserted_edges,
+    const std::vector<std::pair<int64_t, int64_t>> &removed_edges,
+    DynoGraph::Range<int64_t> data);
+
+// Versions that traverse a CSR snapshot of the graph, results are returned for local vertices
+std::vector<int64_t> run_bfs(const local_csr &csr, const Graph &g, int64_t source);
+std::vector<uint64_t> run_multi_source_bfs(const local_csr &csr, const Graph &g, const std::vector<int64_t> &sources,
+    DynoGraph::Range<int64_t> data);
+std::vector<double> run_pagerank(const local_csr &csr, const Graph &g, DynoGraph::Range<int64_t> data);
 
 
 #endif //BOOST_DYNOGRAPH_BOOST_ALGS_H
@@ -1,54 +1,197 @@
 
 #include "boost_dynamic_graph.h"
 #include "boost_algs.h"
+#include "mpi_exchange.h"
+#include <algorithm>
 #include <chrono>
 #include <sstream>
 #include <vector>
 #include <functional>
 #include <tuple>
+#include <limits>
 #include <dynograph_util/hooks/dynograph_edge_count.h>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 
 BOOST_IS_BITWISE_SERIALIZABLE(DynoGraph::Edge);
 BOOST_IS_BITWISE_SERIALIZABLE(DynoGraph::vertex_degree);
 
 using std::vector;
 
+// Returns true if the environment variable is set to a nonzero value
+static bool
+env_flag(const char* name)
+{
+    const char* value = getenv(name);
+    return value != NULL && atoi(value) != 0;
+}
+
+// Returns true if batches should be distributed with point-to-point messages instead of alltoallv
+static bool
+use_sparse_exchange()
+{
+    static const bool sparse = env_flag("BOOST_DYNOGRAPH_SPARSE_EXCHANGE");
+    return sparse;
+}
+
+// Returns true if alg_names contains any of the given algorithms
+static bool
+has_any_alg(const vector<std::string> &alg_names, std::initializer_list<const char*> algs)
+{
+    for (const char* alg : algs)
+    {
+        if (std::find(alg_names.begin(), alg_names.end(), alg) != alg_names.end()) { return true; }
+    }
+    return false;
+}
+
+// Returns the number of threads to use for applying updates within each rank
+static int
+get_num_update_threads()
+{
+    if (const char* value = getenv("BOOST_DYNOGRAPH_THREADS")) {
+        return std::max(1, atoi(value));
+    }
+#if defined(_OPENMP)
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+static int
+get_thread_id()
+{
+#if defined(_OPENMP)
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+// Milliseconds elapsed since t1
+static double
+elapsed_ms(std::chrono::steady_clock::time_point t1)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t1).count();
+}
+
 boost_dynamic_graph::boost_dynamic_graph(DynoGraph::Args args, int64_t max_vertex_id)
 : DynoGraph::DynamicGraph(args, max_vertex_id)
 , g(static_cast<BoostVertexId>(max_vertex_id+1))
 , global_max_nv(max_vertex_id+1)
-{}
+, local_num_edges(0)
+, global_counts_valid(false)
+, use_csr(env_flag("BOOST_DYNOGRAPH_FREEZE"))
+, csr_valid(false)
+, num_threads(get_num_update_threads())
+, pending_deletions(true)
+, epoch_deletions(true)
+, use_incremental_traversal(env_flag("BOOST_DYNOGRAPH_INCREMENTAL_TRAVERSAL")
+    && has_any_alg(args.alg_names, {"sssp"}))
+{
+    track_new_edges = use_incremental_traversal || has_any_alg(args.alg_names, {"cc", "pagerank"});
+}
 
 boost_dynamic_graph::boost_dynamic_graph(DynoGraph::Args args, int64_t max_vertex_id, const DynoGraph::Batch & batch)
-: DynoGraph::DynamicGraph(args, max_vertex_id)
-, g(static_cast<BoostVertexId>(max_vertex_id+1))
-, global_max_nv(max_vertex_id+1)
+: boost_dynamic_graph(args, max_vertex_id)
 {
-    for (const DynoGraph::Edge &e : batch) {
-        boost::add_edge(
-            boost::vertex(e.src, g),
-            boost::vertex(e.dst, g),
-            // Boost uses template nesting to implement multiple edge properties
-            Weight(e.weight, Timestamp(e.timestamp)),
-            g
-        );
-    }
-    synchronize(g);
+    // Each rank may hold a different part of the batch, so it has to be distributed like any other update
+    insert_batch(batch);
+    // Nothing has run on this graph yet, so there is no previous result to update with these edges
+    pending_new_edges.clear();
+    pending_new_edges.shrink_to_fit();
+    pending_reweighted_edges.clear();
+    pending_reweighted_edges.shrink_to_fit();
 }
 
+// Records a change in the out-degree of a local vertex
 void
-boost_dynamic_graph::before_batch(const DynoGraph::Batch &batch, int64_t threshold) {
+boost_dynamic_graph::update_degree(int64_t vertex_id, int64_t old_degree, int64_t new_degree)
+{
+    local_num_edges += new_degree - old_degree;
+    local_degrees.update(vertex_id, old_degree, new_degree);
+}
 
+void
+boost_dynamic_graph::before_batch(const DynoGraph::Batch &batch, int64_t threshold) {
+    // The sparse exchange needs every rank to keep polling, so it can't run in the background
+    if (use_sparse_exchange()) { return; }
+    // Start sending the batch to the ranks that will insert it, so it can arrive while we do other work
+    vector<edge_update> send_buffer;
+    vector<int> send_counts;
+    partition_batch(g, batch, send_buffer, send_counts);
+    pending_batches.emplace_back(new pending_exchange<edge_update>());
+    pending_batches.back()->post(boost::mpi::communicator(), std::move(send_buffer), send_counts);
 }
 
+// Removes the out-edges older than threshold from a list of local source vertices
 void
-boost_dynamic_graph::delete_edges_older_than(int64_t threshold) {
-    boost::remove_edge_if(
-        [&](const BoostEdge &e)
+boost_dynamic_graph::delete_expired_edges(const vector<int64_t> &sources, int64_t threshold)
+{
+    auto expired = [&](const BoostEdge &e)
+    {
+        return get(boost::edge_timestamp, g, e) < threshold;
+    };
+
+    // Removing an edge also modifies the in-edge list of the target, which may be shared between sources,
+    // so only the search for expired edges is split between threads
+    // The search also records the removed edges for incremental SSSP, so the serial part only has to remove them
+    vector<char> has_expired(sources.size(), 0);
+    vector<vector<std::pair<int64_t, int64_t>>> thread_removed_edges(num_threads);
+    vector<double> thread_times(num_threads, 0);
+    #pragma omp parallel num_threads(num_threads)
+    {
+        auto t1 = std::chrono::steady_clock::now();
+        auto& removed_edges = thread_removed_edges[get_thread_id()];
+        #pragma omp for schedule(dynamic, 64) nowait
+        for (size_t i = 0; i < sources.size(); ++i)
         {
-            return get(boost::edge_timestamp, g, e) < threshold;
+            BoostVertex v = boost::vertex(sources[i], g);
+            BGL_FORALL_OUTEDGES_T(v, e, g, decltype(g))
+            {
+                if (!expired(e)) { continue; }
+                has_expired[i] = 1;
+                if (!use_incremental_traversal) { break; }
+                removed_edges.emplace_back(sources[i], get_global_id(g, boost::target(e, g)));
+            }
         }
-        ,g);
+        thread_times[get_thread_id()] = elapsed_ms(t1);
+    }
+    Hooks::getInstance().set_stat("thread_time_ms", thread_times);
+    for (const auto& removed_edges : thread_removed_edges)
+    {
+        pending_removed_edges.insert(pending_removed_edges.end(), removed_edges.begin(), removed_edges.end());
+    }
+
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        if (!has_expired[i]) { continue; }
+        BoostVertex v = boost::vertex(sources[i], g);
+        int64_t old_degree = boost::out_degree(v, g);
+        boost::remove_out_edge_if(v, expired, g);
+        update_degree(sources[i], old_degree, boost::out_degree(v, g));
+        pending_deletions = true;
+    }
+}
+
+void
+boost_dynamic_graph::delete_edges_older_than(int64_t threshold) {
+#if USE_EDGE_TIME_INDEX
+    // Only visit the local vertices that were touched by batches older than the threshold
+    delete_expired_edges(time_index.expire(threshold), threshold);
+#else
+    vector<int64_t> sources;
+    BGL_FORALL_VERTICES_T(v, g, decltype(g))
+    {
+        sources.push_back(get_global_id(g, v));
+    }
+    delete_expired_edges(sources, threshold);
+#endif
+    // Every rank must agree that the global counts need to be reduced again
+    global_counts_valid = false;
+    csr_valid = false;
     synchronize(g);
 }
 
@@ -74,56 +217,85 @@ operator<(const edge_update& a, const edge_update& b)
            < std::tie(b.src, b.dst, b.weight, b.timestamp, b.done);
 }
 
-// Splits up the batch up updates, sending each edge to the rank that owns the source vertex
+// Sends send_counts[r] updates to rank r, and receives the updates sent to this rank
+static void
+exchange_updates(const vector<edge_update> &send_buffer, const vector<int> &send_counts, vector<edge_update> &local_updates)
+{
+    auto comm = boost::mpi::communicator();
+    if (use_sparse_exchange()) {
+        sparse_exchange(comm, send_buffer.data(), send_counts, local_updates);
+    } else {
+        exchange(comm, send_buffer.data(), send_counts, local_updates);
+    }
+}
+
+// Groups this rank's part of the batch by the rank that owns the source vertex
+// send_counts[r] is set to the number of updates for rank r, which are stored contiguously in send_buffer
 void
-boost_dynamic_graph::scatter_batch(const Graph& g, const DynoGraph::Batch &batch, vector<edge_update>& local_updates)
+boost_dynamic_graph::partition_batch(const Graph& g, const DynoGraph::Batch &batch,
+    vector<edge_update> &send_buffer, vector<int> &send_counts)
 {
     auto comm = boost::mpi::communicator();
     const int num_ranks = comm.size();
 
-    if (comm.rank() == 0)
+    // Partition the batch by the rank that owns the source vertex, using a counting sort
+    // Each thread handles a contiguous chunk of the batch, so the order of edges within each rank is preserved
+    const int64_t num_updates = batch.size();
+    const int num_chunks = get_num_update_threads();
+    auto chunk_begin = [&](int chunk) { return (num_updates * chunk) / num_chunks; };
+
+    // Look up the owner of each edge once, and count the number of updates for each rank in each chunk
+    vector<int> owners(num_updates);
+    vector<int64_t> offsets(num_chunks * num_ranks, 0);
+    #pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+    for (int chunk = 0; chunk < num_chunks; ++chunk)
     {
-        // Copy the batch to a local list
-        vector<edge_update> global_updates(batch.begin(), batch.end());
-        // Sort the list of updates by the rank that owns the source vertex
-        auto by_mapping = [&g](const edge_update &a, const edge_update &b) {
-            BoostVertex va = boost::vertex(a.src, g);
-            BoostVertex vb = boost::vertex(b.src, g);
-            return va.owner < vb.owner;
-        };
-        std::sort(global_updates.begin(), global_updates.end(), by_mapping);
-
-        // Scan the list to calculate the number of updates for each rank
-        vector<int> sizes_by_rank(num_ranks, 0);
-        for (auto iter = global_updates.begin(); iter < global_updates.end();)
+        int64_t* counts = &offsets[chunk * num_ranks];
+        for (int64_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i)
         {
-            // Owner of current range
-            int current_rank = boost::vertex(iter->src, g).owner;
-            // Start of range
-            auto prev = iter;
-            // Find the position of the first update that does not belong to this rank
-            iter = std::upper_bound(global_updates.begin(), global_updates.end(), *iter, by_mapping);
-            // Compute length of range
-            sizes_by_rank[current_rank] = iter - prev;
+            owners[i] = boost::vertex(batch[i].src, g).owner;
+            counts[owners[i]] += 1;
         }
+    }
 
-        // Send number of updates for each rank
-        int local_num_updates;
-        boost::mpi::scatter(comm, sizes_by_rank, local_num_updates, 0);
-        // Allocate buffer
-        local_updates.resize(local_num_updates);
-        // Scatter the updates to the proper rank
-        boost::mpi::scatterv(comm, global_updates.data(), sizes_by_rank, local_updates.data(), 0);
+    // Scan the counts in rank-major order to find where each chunk writes its updates for each rank
+    vector<int64_t> rank_counts(num_ranks, 0);
+    int64_t total = 0;
+    for (int rank = 0; rank < num_ranks; ++rank)
+    {
+        for (int chunk = 0; chunk < num_chunks; ++chunk)
+        {
+            int64_t count = offsets[chunk * num_ranks + rank];
+            offsets[chunk * num_ranks + rank] = total;
+            total += count;
+            rank_counts[rank] += count;
+        }
+    }
+    send_counts = checked_counts(comm, rank_counts);
 
-    } else {
-        // Receive number of updates for this rank
-        int local_num_updates;
-        boost::mpi::scatter(comm, local_num_updates, 0);
-        // Allocate buffer
-        local_updates.resize(local_num_updates);
-        // Receive list of local updates
-        boost::mpi::scatterv(comm, local_updates.data(), local_num_updates, 0);
+    // Copy each update straight into its slot in the send buffer
+    send_buffer.resize(num_updates);
+    #pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+    for (int chunk = 0; chunk < num_chunks; ++chunk)
+    {
+        int64_t* pos = &offsets[chunk * num_ranks];
+        for (int64_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i)
+        {
+            send_buffer[pos[owners[i]]++] = edge_update(batch[i]);
+        }
     }
+
+}
+
+// Sends each edge in this rank's part of the batch to the rank that owns the source vertex
+// Any rank may hold any part of the batch, local_updates receives every update for local source vertices
+void
+boost_dynamic_graph::scatter_batch(const Graph& g, const DynoGraph::Batch &batch, vector<edge_update>& local_updates)
+{
+    vector<edge_update> send_buffer;
+    vector<int> send_counts;
+    partition_batch(g, batch, send_buffer, send_counts);
+    exchange_updates(send_buffer, send_counts, local_updates);
 }
 
 void
@@ -139,45 +311,111 @@ boost_dynamic_graph::insert_batch(const DynoGraph::Batch &batch)
      */
 
     // 1. Distribute the updates to the rank that will perform them
+    // If before_batch already sent out this batch, just wait for it to arrive
     auto comm = boost::mpi::communicator();
     vector<edge_update> local_updates;
-    boost_dynamic_graph::scatter_batch(g, batch, local_updates);
+    if (!pending_batches.empty()) {
+        local_updates.swap(pending_batches.front()->wait());
+        Hooks::getInstance().set_stat("exposed_comm_ms", pending_batches.front()->get_blocked_ms());
+        pending_batches.pop_front();
+    } else {
+        vector<edge_update> send_buffer;
+        vector<int> send_counts;
+        partition_batch(g, batch, send_buffer, send_counts);
+        auto t1 = std::chrono::steady_clock::now();
+        exchange_updates(send_buffer, send_counts, local_updates);
+        Hooks::getInstance().set_stat("exposed_comm_ms", elapsed_ms(t1));
+    }
 
     // 2. Update existing edges
+    // Sorting groups the updates by source vertex, so we only need to walk the
+    // out-edges of vertices that are touched by this batch
     std::sort(local_updates.begin(), local_updates.end());
     auto same_src_and_dst = [](const edge_update& a, const edge_update& b) { return a.src == b.src && a.dst == b.dst; };
-    // TODO Filter by source vertex to reduce search time
-    BGL_FORALL_EDGES_T(e, g, decltype(g))
+    auto dst_compare = [](const edge_update& a, const edge_update& b) { return a.dst < b.dst; };
+    // Find the range of updates with each source vertex
+    vector<size_t> group_begin;
+    for (size_t i = 0; i < local_updates.size(); ++i)
     {
-        // Make sure we are updating local vertices
-        assert(e.source_owns_edge && e.source_processor == comm.rank());
-
-        auto src_dst_compare = [](const edge_update& a, const edge_update& b) {
-            return std::tie(a.src, a.dst) < std::tie(b.src, b.dst);
-        };
-        // Find and perform updates that match this edge
-        edge_update key;
-        key.src = e.local.m_source;
-        key.dst = e.local.m_target;
-        auto weight = get(boost::edge_weight, g, e);
-        auto timestamp = get(boost::edge_timestamp, g, e);
-        // Use binary search to find the first matching update
-        for (auto u = binary_find(local_updates.begin(), local_updates.end(), key, src_dst_compare);
-        // Keep walking the list until we reach the last update for this edge
-            u < local_updates.end() && !src_dst_compare(key, *u); ++u)
+        if (i == 0 || local_updates[i].src != local_updates[i-1].src) { group_begin.push_back(i); }
+    }
+    group_begin.push_back(local_updates.size());
+    const int64_t num_groups = static_cast<int64_t>(group_begin.size()) - 1;
+
+    // Each source vertex is handled by exactly one thread, so no locks are needed
+    // Remember the degree of each source vertex before the update
+    vector<DynoGraph::vertex_degree> touched(num_groups);
+    vector<double> thread_times(num_threads, 0);
+    #pragma omp parallel num_threads(num_threads)
+    {
+        auto t1 = std::chrono::steady_clock::now();
+        #pragma omp for schedule(dynamic, 16) nowait
+        for (int64_t group = 0; group < num_groups; ++group)
         {
-            // Increment edge weight
-            weight += u->weight;
-            // Update timestamp
-            timestamp = std::max(timestamp, u->timestamp);
-            // Mark this update as done
-            u->mark_done();
+            auto first = local_updates.begin() + group_begin[group];
+            auto last = local_updates.begin() + group_begin[group + 1];
+            BoostVertex Src = boost::vertex(first->src, g);
+            // Make sure we are updating local vertices
+            assert(Src.owner == comm.rank());
+            touched[group] = DynoGraph::vertex_degree(first->src, boost::out_degree(Src, g));
+
+            BGL_FORALL_OUTEDGES_T(Src, e, g, decltype(g))
+            {
+                // Find and perform updates that match this edge
+                edge_update key;
+                key.dst = get_global_id(g, boost::target(e, g));
+                auto weight = get(boost::edge_weight, g, e);
+                auto timestamp = get(boost::edge_timestamp, g, e);
+                // Within a source vertex the updates are sorted by destination,
+                // so use binary search to find the first matching update
+                for (auto u = binary_find(first, last, key, dst_compare);
+                // Keep walking the list until we reach the last update for this edge
+                    u < last && !dst_compare(key, *u); ++u)
+                {
+                    // Increment edge weight
+                    weight += u->weight;
+                    // Update timestamp
+                    timestamp = std::max(timestamp, u->timestamp);
+                    // Mark this update as done
+                    u->mark_done();
+                }
+                put(boost::edge_weight, g, e, weight);
+                put(boost::edge_timestamp, g, e, timestamp);
+            }
+        }
+        thread_times[get_thread_id()] = elapsed_ms(t1);
+    }
+    Hooks::getInstance().set_stat("thread_time_ms", thread_times);
+
+#if USE_EDGE_TIME_INDEX
+    // Remember which sources were touched by this batch, for use in delete_edges_older_than
+    if (!local_updates.empty())
+    {
+        vector<int64_t> sources(touched.size());
+        std::transform(touched.begin(), touched.end(), sources.begin(),
+            [](const DynoGraph::vertex_degree& v) { return v.vertex_id; });
+        int64_t min_timestamp = std::numeric_limits<int64_t>::max();
+        int64_t max_timestamp = std::numeric_limits<int64_t>::min();
+        for (const edge_update& u : local_updates)
+        {
+            min_timestamp = std::min(min_timestamp, u.timestamp);
+            max_timestamp = std::max(max_timestamp, u.timestamp);
+        }
+        time_index.add_segment(std::move(sources), min_timestamp, max_timestamp);
+    }
+#endif
+
+    // Heavier edges may no longer be on the shortest path, so SSSP treats them like removed edges
+    if (use_incremental_traversal)
+    {
+        for (const edge_update& u : local_updates)
+        {
+            if (u.is_done()) { pending_reweighted_edges.emplace_back(u.src, u.dst); }
         }
-        put(boost::edge_weight, g, e, weight);
-        put(boost::edge_timestamp, g, e, timestamp);
     }
 
     // 3. Add any remaining updates to the graph as new edges
+    // Adding an edge also modifies the in-edge list of the target, so this step is serial
     for (auto u = local_updates.begin(); u < local_updates.end();)
     {
         // Skip past updates that were processed in step 2
@@ -193,6 +431,9 @@ boost_dynamic_graph::insert_batch(const DynoGraph::Batch &batch)
         BoostVertex Src = boost::vertex(u->src, g);
         BoostVertex Dst = boost::vertex(u->dst, g);
 
+        // Remember the new edge for incremental algorithms
+        if (track_new_edges) { pending_new_edges.emplace_back(u->src, u->dst); }
+
         // Combine properties from this and all duplicates of this edge
         int64_t weight = 0;
         int64_t timestamp = 0;
@@ -211,13 +452,90 @@ boost_dynamic_graph::insert_batch(const DynoGraph::Batch &batch)
             g
         );
     }
+
+    // Update edge count and degree index with the new degree of each touched vertex
+    for (const DynoGraph::vertex_degree& v : touched)
+    {
+        update_degree(v.vertex_id, v.out_degree, boost::out_degree(boost::vertex(v.vertex_id, g), g));
+    }
+    // Every rank must agree that the global counts need to be reduced again
+    global_counts_valid = false;
+    csr_valid = false;
     synchronize(g);
 }
 
+// Rebuilds the CSR snapshot of the local edges
+void
+boost_dynamic_graph::freeze()
+{
+    csr.freeze(g);
+    csr_valid = true;
+}
+
+void
+boost_dynamic_graph::before_algs()
+{
+    // Start a new epoch of changes for incremental algorithms
+    // Each alg trial in this epoch starts from the same results, so they all need the same list
+    epoch_new_edges.swap(pending_new_edges);
+    pending_new_edges.clear();
+    epoch_deletions = boost::mpi::all_reduce(boost::mpi::communicator(), pending_deletions, std::logical_or<bool>());
+    pending_deletions = false;
+    epoch_removed_edges.swap(pending_removed_edges);
+    pending_removed_edges.clear();
+    epoch_reweighted_edges.swap(pending_reweighted_edges);
+    pending_reweighted_edges.clear();
+    epoch_trees = pending_trees;
+    epoch_algs.swap(pending_algs);
+    pending_algs.clear();
+    std::swap(epoch_pagerank, pending_pagerank);
+
+    // Take a snapshot of the graph before the first algorithm in the epoch runs
+    if (use_csr && !csr_valid)
+    {
+        Hooks &hooks = Hooks::getInstance();
+        hooks.region_begin("freeze");
+        freeze();
+        hooks.region_end();
+    }
+}
+
 void
 boost_dynamic_graph::update_alg(const std::string &alg_name, const std::vector<int64_t> &sources, DynoGraph::Range<int64_t> data) {
-    // TODO set alg data
-    runAlgorithm(alg_name, g, sources);
+    // The previous results in data can only be updated if they were computed on this graph in the previous epoch
+    bool has_previous = epoch_algs.count(alg_name) > 0;
+    pending_algs.insert(alg_name);
+    // Insertions can only merge components, so just apply the new edges to the previous labels
+    if (alg_name == "cc" && has_previous && !epoch_deletions) {
+        if (run_incremental_cc(g, epoch_new_edges, data)) { return; }
+    }
+    // Keep pushing residuals from where the previous epoch stopped, instead of sweeping every edge again
+    if (alg_name == "pagerank") {
+        const pagerank_state *previous = has_previous && !epoch_deletions ? &epoch_pagerank : nullptr;
+        if (use_csr) {
+            if (!csr_valid) { freeze(); }
+            pending_pagerank = run_incremental_pagerank(csr, g, previous, epoch_new_edges, data);
+        } else {
+            pending_pagerank = run_incremental_pagerank(g, previous, epoch_new_edges, data);
+        }
+        return;
+    }
+    // Repair the tree from the previous epoch, instead of traversing the whole graph again
+    if (use_incremental_traversal && alg_name == "sssp") {
+        vector<std::pair<int64_t, int64_t>> removed_edges = epoch_removed_edges;
+        removed_edges.insert(removed_edges.end(), epoch_reweighted_edges.begin(), epoch_reweighted_edges.end());
+        auto previous = epoch_trees.find(alg_name);
+        pending_trees[alg_name] = run_incremental_traversal(g, sources[0], true,
+            previous == epoch_trees.end() ? nullptr : &previous->second,
+            epoch_new_edges, removed_edges, data);
+        return;
+    }
+    if (use_csr) {
+        if (!csr_valid) { freeze(); }
+        // Use the CSR version of the algorithm if there is one
+        if (runAlgorithm(alg_name, csr, g, sources, data)) { return; }
+    }
+    runAlgorithm(alg_name, g, sources, data);
 }
 
 int64_t
@@ -235,53 +553,55 @@ boost_dynamic_graph::get_high_degree_vertices(int64_t n) const
 {
     using DynoGraph::vertex_degree;
     auto comm = boost::mpi::communicator();
-    // Get the degree of every local vertex
-    vector<vertex_degree> local_degrees;
-    local_degrees.reserve(num_vertices(g));
-    BGL_FORALL_VERTICES_T(v, g, decltype(g))
-    {
-        local_degrees.emplace_back(v.local, boost::out_degree(v, g));
-    }
-    // Sort to get the vertices with the highest degrees
-    std::sort(local_degrees.begin(), local_degrees.end());
-    // Chop off all but the top N
-    local_degrees.erase(local_degrees.begin(), local_degrees.end() - n);
-    // Get local max from all vertices
+    // Get the top N local vertices from the degree index
+    // Ranks with fewer than N active vertices pad the list with placeholders
+    vector<vertex_degree> local_top = local_degrees.top(n);
+    local_top.resize(n, vertex_degree(-1, -1));
+    // Gather the local top N from every rank
     vector<vertex_degree> global_degrees(n * comm.size());
-    boost::mpi::all_gather(comm, local_degrees.data(), local_degrees.size(), global_degrees.data());
-    // Sort again to get global max
-    std::sort(global_degrees.begin(), global_degrees.end());
-    global_degrees.erase(global_degrees.begin(), global_degrees.end() - n);
-    vector<int64_t> vertex_ids(n);
-    std::transform(global_degrees.begin(), global_degrees.end(), vertex_ids.begin(),
+    boost::mpi::all_gather(comm, local_top.data(), n, global_degrees.data());
+    // Select the global top N, in order of decreasing degree
+    auto last = std::partition(global_degrees.begin(), global_degrees.end(),
+        [](const vertex_degree &a) { return a.out_degree >= 0; });
+    auto middle = global_degrees.begin() + std::min<ptrdiff_t>(n, last - global_degrees.begin());
+    std::partial_sort(global_degrees.begin(), middle, last,
+        [](const vertex_degree &a, const vertex_degree &b) { return b < a; });
+    vector<int64_t> vertex_ids(middle - global_degrees.begin());
+    std::transform(global_degrees.begin(), middle, vertex_ids.begin(),
         [](const vertex_degree &a) { return a.vertex_id; }
     );
     return vertex_ids;
 }
 
+// Sums the local counts across all ranks, unless the graph hasn't changed since the last call
+void
+boost_dynamic_graph::reduce_global_counts() const
+{
+    if (global_counts_valid) { return; }
+    auto comm = communicator(g.process_group());
+    int64_t local_counts[2] = {static_cast<int64_t>(local_degrees.size()), local_num_edges};
+    int64_t global_counts[2];
+    boost::mpi::all_reduce(comm, local_counts, 2, global_counts, std::plus<int64_t>());
+    global_num_vertices = global_counts[0];
+    global_num_edges = global_counts[1];
+    global_counts_valid = true;
+}
+
 int64_t
 boost_dynamic_graph::get_num_vertices() const {
-    auto comm = communicator(g.process_group());
-    int64_t nv = 0;
-    BGL_FORALL_VERTICES_T(v, g, decltype(g))
-    {
-        if (boost::out_degree(v, g) > 0) { nv += 1; }
-    }
-    nv = boost::mpi::all_reduce(comm, nv, std::plus<decltype(nv)>());
-    return nv;
+    reduce_global_counts();
+    return global_num_vertices;
 }
 
 int64_t
 boost_dynamic_graph::get_num_edges() const {
-    auto comm = communicator(g.process_group());
-    auto ne = num_edges(g);
-    ne = boost::mpi::all_reduce(comm, ne, std::plus<decltype(ne)>());
-    return ne;
+    reduce_global_counts();
+    return global_num_edges;
 }
 
 std::vector<std::string>
 boost_dynamic_graph::get_supported_algs() {
-    return {"bfs", "cc", "gc", "sssp", "pagerank"};
+    return {"bc", "bfs", "cc", "gc", "sssp", "pagerank"};
 }
 
 void
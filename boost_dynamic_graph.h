@@ -1,6 +1,14 @@
 #pragma once
 #include <dynograph_util/benchmark.h>
 #include "boost_algs.h"
+#include "edge_time_index.h"
+#include "degree_index.h"
+#include "local_csr.h"
+#include "mpi_exchange.h"
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
 
 class edge_update : public DynoGraph::Edge
 {
@@ -21,11 +29,64 @@ class boost_dynamic_graph : public DynoGraph::DynamicGraph
 protected:
     Graph g;
     BoostVertexId global_max_nv;
+    // Number of edges stored on this rank, maintained during insert/delete
+    int64_t local_num_edges;
+    // Local vertices with at least one out-edge, ordered by degree
+    degree_index local_degrees;
+    // Cached global counts, reduced at most once after each modification of the graph
+    mutable bool global_counts_valid;
+    mutable int64_t global_num_edges;
+    mutable int64_t global_num_vertices;
+    void update_degree(int64_t vertex_id, int64_t old_degree, int64_t new_degree);
+    void reduce_global_counts() const;
+    // Read-optimized snapshot of the local edges, for algorithms that support it
+    bool use_csr;
+    bool csr_valid;
+    local_csr csr;
+    void freeze();
+    // Number of threads used to apply updates on this rank
+    int num_threads;
+    void delete_expired_edges(const std::vector<int64_t> &sources, int64_t threshold);
+    // Connected components and PageRank are updated incrementally if edges were only added since the previous epoch,
+    // and SSSP uses the added edges to repair the previous tree
+    // Edges added to local vertices since the last call to before_algs, and between the last two calls
+    bool track_new_edges;
+    std::vector<std::pair<int64_t, int64_t>> pending_new_edges;
+    std::vector<std::pair<int64_t, int64_t>> epoch_new_edges;
+    // Whether any edges were deleted in the same periods, on any rank
+    // A new graph starts out as if edges were deleted, since the previous results may not describe it
+    bool pending_deletions;
+    bool epoch_deletions;
+    // SSSP repairs the previous shortest-path tree, if enabled with BOOST_DYNOGRAPH_INCREMENTAL_TRAVERSAL
+    // BFS writes a mask of the sources that reach each vertex instead of distances, so it always runs in full
+    // Edges removed from local vertices, and existing edges that got heavier, in the same periods
+    bool use_incremental_traversal;
+    std::vector<std::pair<int64_t, int64_t>> pending_removed_edges;
+    std::vector<std::pair<int64_t, int64_t>> epoch_removed_edges;
+    std::vector<std::pair<int64_t, int64_t>> pending_reweighted_edges;
+    std::vector<std::pair<int64_t, int64_t>> epoch_reweighted_edges;
+    // Algorithms that ran on this graph instance in the current epoch, and in the previous one
+    // Previous results that came from another instance (e.g. the last snapshot) can't be updated incrementally
+    std::set<std::string> pending_algs;
+    std::set<std::string> epoch_algs;
+    // Tree computed by each traversal in the current epoch, and the one it started from
+    std::map<std::string, traversal_tree> pending_trees;
+    std::map<std::string, traversal_tree> epoch_trees;
+    // Ranks and residuals computed by PageRank in the current epoch, and the ones it started from
+    pagerank_state pending_pagerank;
+    pagerank_state epoch_pagerank;
+    // Batches that were sent out by before_batch, but have not been inserted yet
+    std::deque<std::unique_ptr<pending_exchange<edge_update>>> pending_batches;
+#if USE_EDGE_TIME_INDEX
+    // Tracks which local vertices were touched by each batch, so deletions can skip the full scan
+    edge_time_index time_index;
+#endif
 public:
     boost_dynamic_graph(DynoGraph::Args args, int64_t max_vertex_id);
     boost_dynamic_graph(DynoGraph::Args args, int64_t max_vertex_id, const DynoGraph::Batch & batch);
 
     virtual void before_batch(const DynoGraph::Batch &batch, int64_t threshold) override;
+    virtual void before_algs() override;
     virtual void delete_edges_older_than(int64_t threshold) override;
     virtual void insert_batch(const DynoGraph::Batch &batch) override;
     virtual void update_alg(const std::string &alg_name, const std::vector<int64_t> &sources, DynoGraph::Range<int64_t> data);
@@ -37,6 +98,8 @@ public:
 
     void dump() const;
 
+    static void partition_batch(const Graph& g, const DynoGraph::Batch &batch,
+        std::vector<edge_update> &send_buffer, std::vector<int> &send_counts);
     static void scatter_batch(const Graph& g, const DynoGraph::Batch &batch, std::vector<edge_update> &local_updates);
 
 };
@@ -1,5 +1,13 @@
 #include "boost_dynamic_graph.h"
 #include <dynograph_util/dynograph_impl_test.h>
+#include <dynograph_util/distributed_dataset.h>
+#include "mpi_exchange.h"
+#include <numeric>
+#include <functional>
+#include <cmath>
+#include <map>
+#include <queue>
+#include <set>
 
 INSTANTIATE_TYPED_TEST_CASE_P(BOOST_DYNOGRAPH, ImplTest, boost_dynamic_graph);
 
@@ -20,11 +28,15 @@ TEST(BOOST_DYNOGRAPH, ScatterBatchTest)
     DynoGraph::EdgeListDataset dataset(args);
     Graph graph(dataset.getMaxVertexId() + 1);
 
+    auto comm = boost::mpi::communicator();
+
+    // Each rank starts out with a different slice of the batch
     auto batch = dataset.getBatch(0);
+    size_t slice_begin = (batch->size() * comm.rank()) / comm.size();
+    size_t slice_end = (batch->size() * (comm.rank() + 1)) / comm.size();
+    DynoGraph::Batch slice(batch->begin() + slice_begin, batch->begin() + slice_end);
     std::vector<edge_update> local_updates;
-    boost_dynamic_graph::scatter_batch(graph, *batch, local_updates);
-
-    auto comm = boost::mpi::communicator();
+    boost_dynamic_graph::scatter_batch(graph, slice, local_updates);
 
     // Make sure all updates ended up somewhere
     size_t global_num_updates = 0;
@@ -42,6 +54,632 @@ TEST(BOOST_DYNOGRAPH, ScatterBatchTest)
 
 }
 
+// Make sure updates to existing edges are matched no matter which rank owns the source vertex
+TEST(BOOST_DYNOGRAPH, UpdateExistingEdgesOnAllRanks)
+{
+    DynoGraph::Args args = {1, "dummy", 3, {}, DynoGraph::Args::SORT_MODE::UNSORTED, 1.0, 1};
+    boost_dynamic_graph graph(args, 1000);
+    auto comm = boost::mpi::communicator();
+
+    // Spread the source and destination vertices across the whole ID range
+    std::vector<DynoGraph::Edge> edges = {
+        {10, 990, 1, 100},
+        {10, 500, 1, 100},
+        {300, 700, 1, 200},
+        {600, 20, 1, 300},
+        {990, 10, 1, 400},
+    };
+    DynoGraph::Batch batch(edges.begin(), edges.end());
+    graph.insert_batch(comm.rank() == 0 ? batch : DynoGraph::Batch());
+    EXPECT_EQ(graph.get_num_edges(), 5);
+
+    // Inserting the same edges again, from a different rank, should only update them
+    graph.insert_batch(comm.rank() == comm.size() - 1 ? batch : DynoGraph::Batch());
+    EXPECT_EQ(graph.get_num_edges(), 5);
+    EXPECT_EQ(graph.get_out_degree(10), 2);
+    EXPECT_EQ(graph.get_out_degree(990), 1);
+}
+
+// Make sure deletions under a sliding window leave the graph in the same state as the reference,
+// and that the maintained edge and vertex counts stay in sync
+TEST(BOOST_DYNOGRAPH, SlidingWindowDeletes)
+{
+    DynoGraph::Args args;
+    args.input_path = "dynograph_util/data/worldcup-10K.graph.bin";
+    args.batch_size = 500;
+    args.num_epochs = 1;
+    args.sort_mode = DynoGraph::Args::SORT_MODE::UNSORTED;
+    args.num_trials = 1;
+    args.num_alg_trials = 1;
+    args.window_size = 0.3;
+    // Every rank loads the whole dataset, so the reference graph sees every batch
+    DynoGraph::EdgeListDataset dataset(args);
+    boost_dynamic_graph graph(args, dataset.getMaxVertexId());
+    reference_impl ref_graph(args, dataset.getMaxVertexId());
+    auto comm = boost::mpi::communicator();
+
+    for (int64_t batch_id = 0; batch_id < dataset.getNumBatches(); ++batch_id)
+    {
+        int64_t threshold = dataset.getTimestampForWindow(batch_id);
+        graph.delete_edges_older_than(threshold);
+        ref_graph.delete_edges_older_than(threshold);
+        ASSERT_EQ(graph.get_num_edges(), ref_graph.get_num_edges());
+        ASSERT_EQ(graph.get_num_vertices(), ref_graph.get_num_vertices());
+
+        // Each rank inserts a different slice of the batch
+        auto batch = dataset.getBatch(batch_id);
+        size_t slice_begin = (batch->size() * comm.rank()) / comm.size();
+        size_t slice_end = (batch->size() * (comm.rank() + 1)) / comm.size();
+        graph.insert_batch(DynoGraph::Batch(batch->begin() + slice_begin, batch->begin() + slice_end));
+        ref_graph.insert_batch(*batch);
+        ASSERT_EQ(graph.get_num_edges(), ref_graph.get_num_edges());
+        ASSERT_EQ(graph.get_num_vertices(), ref_graph.get_num_vertices());
+    }
+}
+
+// Make sure the ranks can read the file in parallel and together produce the same batches
+TEST(BOOST_DYNOGRAPH, DistributedDatasetMatchesEdgeList)
+{
+    DynoGraph::Args args;
+    args.input_path = "dynograph_util/data/worldcup-10K.graph.bin";
+    // Not divisible by the number of ranks, and leaves a partial batch at the end of the file
+    args.batch_size = 999;
+    args.num_epochs = 1;
+    args.sort_mode = DynoGraph::Args::SORT_MODE::UNSORTED;
+    args.num_trials = 1;
+    args.num_alg_trials = 1;
+    args.window_size = 0.3;
+    DynoGraph::EdgeListDataset expected(args);
+    DynoGraph::DistributedDataset actual(args);
+    auto comm = boost::mpi::communicator();
+
+    EXPECT_EQ(expected.getNumBatches(), actual.getNumBatches());
+    EXPECT_EQ(expected.getNumEdges(), actual.getNumEdges());
+    EXPECT_EQ(expected.getMaxVertexId(), actual.getMaxVertexId());
+    EXPECT_EQ(expected.getMinTimestamp(), actual.getMinTimestamp());
+    EXPECT_EQ(expected.getMaxTimestamp(), actual.getMaxTimestamp());
+    // Each rank holds one contiguous piece of each batch, and together they cover the whole batch
+    auto check_slice = [&](const DynoGraph::Batch& expected_batch, const DynoGraph::Batch& actual_batch)
+    {
+        std::vector<size_t> slice_sizes;
+        boost::mpi::all_gather(comm, actual_batch.size(), slice_sizes);
+        size_t offset = std::accumulate(slice_sizes.begin(), slice_sizes.begin() + comm.rank(), size_t(0));
+        EXPECT_EQ(expected_batch.size(), std::accumulate(slice_sizes.begin(), slice_sizes.end(), size_t(0)));
+        EXPECT_TRUE(std::equal(actual_batch.begin(), actual_batch.end(), expected_batch.begin() + offset));
+    };
+    std::vector<DynoGraph::Edge> local_slices;
+    for (int64_t batch_id = 0; batch_id < expected.getNumBatches(); ++batch_id)
+    {
+        EXPECT_EQ(expected.getTimestampForWindow(batch_id), actual.getTimestampForWindow(batch_id));
+        auto slice = actual.getBatch(batch_id);
+        check_slice(*expected.getBatch(batch_id), *slice);
+        local_slices.insert(local_slices.end(), slice->begin(), slice->end());
+    }
+    // The cumulative batch holds this rank's slice of every batch so far
+    auto cumulative = actual.getBatchesUpTo(expected.getNumBatches() - 1);
+    ASSERT_EQ(local_slices.size(), cumulative->size());
+    EXPECT_TRUE(std::equal(local_slices.begin(), local_slices.end(), cumulative->begin()));
+}
+
+// Make sure the sparse exchange delivers the same values as the all-to-all version
+TEST(BOOST_DYNOGRAPH, SparseExchangeMatchesAllToAll)
+{
+    auto comm = boost::mpi::communicator();
+    const int num_ranks = comm.size();
+    // Each rank sends rank+1 values to the next rank, and one value to itself
+    std::vector<int> send_counts(num_ranks, 0);
+    send_counts[(comm.rank() + 1) % num_ranks] += comm.rank() + 1;
+    send_counts[comm.rank()] += 1;
+    std::vector<int64_t> send_buffer;
+    for (int r = 0; r < num_ranks; ++r) {
+        for (int i = 0; i < send_counts[r]; ++i) { send_buffer.push_back(comm.rank() * 1000 + r * 10 + i); }
+    }
+
+    // Run it twice, to make sure consecutive exchanges don't mix up their messages
+    for (int round = 0; round < 2; ++round)
+    {
+        std::vector<int64_t> expected, actual;
+        std::vector<int> expected_counts = exchange(comm, send_buffer.data(), send_counts, expected);
+        std::vector<int> actual_counts = sparse_exchange(comm, send_buffer.data(), send_counts, actual);
+        EXPECT_EQ(expected_counts, actual_counts);
+        EXPECT_EQ(expected, actual);
+    }
+}
+
+// Make sure batches sent ahead of time with before_batch are inserted in order
+TEST(BOOST_DYNOGRAPH, InsertBatchesSentAhead)
+{
+    DynoGraph::Args args = {1, "dummy", 3, {}, DynoGraph::Args::SORT_MODE::UNSORTED, 1.0, 1};
+    boost_dynamic_graph graph(args, 1000);
+    auto comm = boost::mpi::communicator();
+
+    std::vector<DynoGraph::Edge> first = {{10, 990, 1, 100}, {600, 20, 1, 100}};
+    std::vector<DynoGraph::Edge> second = {{10, 990, 1, 200}, {990, 10, 1, 200}};
+    // Only rank 0 holds the batches, like with the default dataset
+    DynoGraph::Batch first_batch, second_batch;
+    if (comm.rank() == 0) {
+        first_batch = DynoGraph::Batch(first.begin(), first.end());
+        second_batch = DynoGraph::Batch(second.begin(), second.end());
+    }
+
+    // Both batches are in flight before the first one is inserted
+    graph.before_batch(first_batch, 0);
+    graph.before_batch(second_batch, 0);
+    graph.insert_batch(first_batch);
+    EXPECT_EQ(graph.get_num_edges(), 2);
+    graph.insert_batch(second_batch);
+    EXPECT_EQ(graph.get_num_edges(), 3);
+    EXPECT_EQ(graph.get_out_degree(10), 1);
+
+    // Edges from the first batch only should be deleted
+    graph.delete_edges_older_than(150);
+    EXPECT_EQ(graph.get_num_edges(), 2);
+}
+
+// Make sure the highest degree vertices are found no matter which rank owns them,
+// even when asking for more vertices than there are in the graph
+TEST(BOOST_DYNOGRAPH, HighDegreeVerticesOnAllRanks)
+{
+    DynoGraph::Args args = {1, "dummy", 3, {}, DynoGraph::Args::SORT_MODE::UNSORTED, 1.0, 1};
+    boost_dynamic_graph graph(args, 1000);
+
+    // Vertex 900 has degree 3, vertex 400 has degree 2, vertex 10 has degree 1
+    std::vector<DynoGraph::Edge> edges = {
+        {900, 1, 1, 100},
+        {900, 2, 1, 100},
+        {900, 3, 1, 100},
+        {400, 1, 1, 200},
+        {400, 2, 1, 200},
+        {10, 1, 1, 300},
+    };
+    DynoGraph::Batch batch(edges.begin(), edges.end());
+    graph.insert_batch(batch);
+
+    std::vector<int64_t> expected = {900, 400};
+    EXPECT_EQ(graph.get_high_degree_vertices(2), expected);
+
+    expected = {900, 400, 10};
+    EXPECT_EQ(graph.get_high_degree_vertices(64), expected);
+
+    // Deleting edges should demote vertex 900
+    graph.delete_edges_older_than(200);
+    expected = {400, 10};
+    EXPECT_EQ(graph.get_high_degree_vertices(64), expected);
+}
+
+// Make sure the CSR snapshot holds the same edges as the graph, and that the CSR version of BFS works
+TEST(BOOST_DYNOGRAPH, FreezeAndTraverseCSR)
+{
+    Graph graph(1001);
+    auto comm = boost::mpi::communicator();
+    std::vector<DynoGraph::Edge> edges = {
+        {1, 2, 1, 100},
+        {2, 3, 1, 100},
+        {1, 500, 1, 100},
+        {500, 900, 1, 100},
+        {900, 1, 1, 100},
+    };
+    if (comm.rank() == 0) {
+        for (const DynoGraph::Edge& e : edges) {
+            boost::add_edge(boost::vertex(e.src, graph), boost::vertex(e.dst, graph),
+                Weight(e.weight, Timestamp(e.timestamp)), graph);
+        }
+    }
+    synchronize(graph);
+
+    local_csr csr;
+    csr.freeze(graph);
+    EXPECT_EQ(csr.global_num_vertices, 1001);
+    EXPECT_EQ(csr.num_local_edges(), static_cast<int64_t>(num_edges(graph)));
+
+    // Check distances on whichever rank owns each vertex
+    std::vector<int64_t> distance = run_bfs(csr, graph, 1);
+    std::vector<std::pair<int64_t, int64_t>> expected = {
+        {1, 0}, {2, 1}, {3, 2}, {500, 1}, {900, 2}, {4, -1}
+    };
+    for (auto v : expected) {
+        BoostVertex vertex = boost::vertex(v.first, graph);
+        if (static_cast<int>(vertex.owner) == comm.rank()) {
+            EXPECT_EQ(distance[vertex.local], v.second);
+        }
+    }
+}
+
+// Serial power iteration over a list of edges, for checking the distributed PageRank
+// Duplicate edges are combined into one, like in the graph
+static std::vector<double>
+reference_pagerank(const std::vector<DynoGraph::Edge>& edges, int64_t nv)
+{
+    const double damping = 0.85;
+    std::set<std::pair<int64_t, int64_t>> unique_edges;
+    for (const DynoGraph::Edge& e : edges) { unique_edges.insert({e.src, e.dst}); }
+    std::vector<int64_t> degree(nv, 0);
+    for (const auto& e : unique_edges) { degree[e.first] += 1; }
+    std::vector<double> ranks(nv, 1.0 / nv);
+    for (int iter = 0; iter < 200; ++iter)
+    {
+        std::vector<double> sums(nv, 0.0);
+        for (const auto& e : unique_edges) { sums[e.second] += ranks[e.first] / degree[e.first]; }
+        for (int64_t v = 0; v < nv; ++v) { ranks[v] = (1 - damping) / nv + damping * sums[v]; }
+    }
+    return ranks;
+}
+
+// Make sure PageRank converges from a cold start, and from the previous epoch's ranks after more edges are added
+TEST(BOOST_DYNOGRAPH, IncrementalPageRank)
+{
+    DynoGraph::Args args;
+    args.input_path = "dynograph_util/data/worldcup-10K.graph.bin";
+    args.batch_size = 2000;
+    args.num_epochs = 1;
+    args.sort_mode = DynoGraph::Args::SORT_MODE::UNSORTED;
+    args.num_trials = 1;
+    args.num_alg_trials = 1;
+    args.window_size = 1.0;
+    DynoGraph::EdgeListDataset dataset(args);
+    const int64_t nv = dataset.getMaxVertexId() + 1;
+    Graph graph(nv);
+    auto comm = boost::mpi::communicator();
+
+    std::vector<DynoGraph::Edge> edges;
+    // Duplicate edges are skipped, like they would be combined in boost_dynamic_graph
+    std::set<std::pair<int64_t, int64_t>> inserted;
+    auto add_batch = [&](int64_t batch_id) {
+        auto batch = dataset.getBatch(batch_id);
+        edges.insert(edges.end(), batch->begin(), batch->end());
+        if (comm.rank() == 0) {
+            for (const DynoGraph::Edge& e : *batch) {
+                if (!inserted.insert({e.src, e.dst}).second) { continue; }
+                boost::add_edge(boost::vertex(e.src, graph), boost::vertex(e.dst, graph),
+                    Weight(e.weight, Timestamp(e.timestamp)), graph);
+            }
+        }
+        synchronize(graph);
+    };
+    // Each rank only fills in the ranks of its own vertices, so combine them before comparing
+    auto check_ranks = [&](const std::vector<int64_t>& data) {
+        std::vector<double> local_ranks(nv), ranks(nv);
+        std::transform(data.begin(), data.end(), local_ranks.begin(), [](int64_t rank) {
+            return DynoGraph::from_fixed_point(rank, DynoGraph::PAGERANK_FIXED_POINT_SCALE);
+        });
+        boost::mpi::all_reduce(comm, local_ranks.data(), nv, ranks.data(), std::plus<double>());
+        std::vector<double> expected = reference_pagerank(edges, nv);
+        double error = 0;
+        for (int64_t v = 0; v < nv; ++v) { error += std::fabs(ranks[v] - expected[v]); }
+        EXPECT_LT(error, 2e-3);
+    };
+
+    // Cold start, on both the adjacency list and the CSR snapshot
+    add_batch(0);
+    std::vector<int64_t> data(nv, 0), csr_data(nv, 0);
+    run_pagerank(graph, data);
+    check_ranks(data);
+    local_csr csr;
+    csr.freeze(graph);
+    run_pagerank(csr, graph, csr_data);
+    check_ranks(csr_data);
+
+    // Warm start from the previous ranks
+    add_batch(1);
+    run_pagerank(graph, data);
+    check_ranks(data);
+    csr.freeze(graph);
+    run_pagerank(csr, graph, csr_data);
+    check_ranks(csr_data);
+
+    // Continue from the previous epoch's residuals, pushing only the changes from the new edges
+    args.alg_names = {"pagerank"};
+    boost_dynamic_graph dynamic_graph(args, dataset.getMaxVertexId());
+    edges.clear();
+    std::fill(data.begin(), data.end(), 0);
+    for (int64_t batch_id = 0; batch_id < 3; ++batch_id)
+    {
+        auto batch = dataset.getBatch(batch_id);
+        edges.insert(edges.end(), batch->begin(), batch->end());
+        dynamic_graph.insert_batch(comm.rank() == 0 ? *batch : DynoGraph::Batch());
+        dynamic_graph.before_algs();
+        dynamic_graph.update_alg("pagerank", {}, data);
+        check_ranks(data);
+    }
+}
+
+// Serial union-find over a list of edges, labels each vertex with the smallest vertex ID in its component plus one
+static std::vector<int64_t>
+reference_components(const std::vector<DynoGraph::Edge>& edges, int64_t nv)
+{
+    std::vector<int64_t> parent(nv);
+    std::iota(parent.begin(), parent.end(), 0);
+    std::function<int64_t(int64_t)> find = [&](int64_t v) {
+        return parent[v] == v ? v : parent[v] = find(parent[v]);
+    };
+    for (const DynoGraph::Edge& e : edges)
+    {
+        int64_t a = find(e.src), b = find(e.dst);
+        parent[std::max(a, b)] = std::min(a, b);
+    }
+    std::vector<int64_t> labels(nv);
+    for (int64_t v = 0; v < nv; ++v) { labels[v] = find(v) + 1; }
+    return labels;
+}
+
+// Make sure connected components updated with just the new edges stay correct,
+// and that deleting edges falls back to a full run
+TEST(BOOST_DYNOGRAPH, IncrementalConnectedComponents)
+{
+    DynoGraph::Args args;
+    args.input_path = "dynograph_util/data/worldcup-10K.graph.bin";
+    args.alg_names = {"cc"};
+    args.batch_size = 1000;
+    args.num_epochs = 1;
+    args.sort_mode = DynoGraph::Args::SORT_MODE::UNSORTED;
+    args.num_trials = 1;
+    args.num_alg_trials = 1;
+    args.window_size = 1.0;
+    DynoGraph::EdgeListDataset dataset(args);
+    const int64_t nv = dataset.getMaxVertexId() + 1;
+    boost_dynamic_graph graph(args, dataset.getMaxVertexId());
+    auto comm = boost::mpi::communicator();
+
+    std::vector<DynoGraph::Edge> edges;
+    std::vector<int64_t> data(nv, 0);
+    auto check_epoch = [&]() {
+        graph.before_algs();
+        graph.update_alg("cc", {}, data);
+        // Each rank only fills in the labels of its own vertices, so combine them before comparing
+        std::vector<int64_t> labels(nv);
+        boost::mpi::all_reduce(comm, data.data(), nv, labels.data(), std::plus<int64_t>());
+        EXPECT_EQ(reference_components(edges, nv), labels);
+    };
+
+    for (int64_t batch_id = 0; batch_id < 4; ++batch_id)
+    {
+        // Only rank 0 holds the batches, like with the default dataset
+        auto batch = dataset.getBatch(batch_id);
+        edges.insert(edges.end(), batch->begin(), batch->end());
+        graph.insert_batch(comm.rank() == 0 ? *batch : DynoGraph::Batch());
+        check_epoch();
+    }
+
+    // Deleting edges can split components
+    int64_t threshold = dataset.getBatch(2)->begin()->timestamp;
+    graph.delete_edges_older_than(threshold);
+    edges.erase(std::remove_if(edges.begin(), edges.end(),
+        [&](const DynoGraph::Edge& e) { return e.timestamp < threshold; }), edges.end());
+    check_epoch();
+
+    // A graph built from a snapshot can't reuse the labels computed on another graph,
+    // even though no edges were deleted from it
+    auto snapshot = dataset.getBatch(3);
+    edges.assign(snapshot->begin(), snapshot->end());
+    boost_dynamic_graph snapshot_graph(args, dataset.getMaxVertexId(),
+        comm.rank() == 0 ? *snapshot : DynoGraph::Batch());
+    snapshot_graph.before_algs();
+    snapshot_graph.update_alg("cc", {}, data);
+    std::vector<int64_t> labels(nv);
+    boost::mpi::all_reduce(comm, data.data(), nv, labels.data(), std::plus<int64_t>());
+    EXPECT_EQ(reference_components(edges, nv), labels);
+}
+
+// Serial Dijkstra over a list of edges, duplicate edges are combined by adding their weights like in the graph
+// Returns the distance to each vertex from source, -1 for unreached vertices
+static std::vector<int64_t>
+reference_distances(const std::vector<DynoGraph::Edge>& edges, int64_t nv, int64_t source, bool weighted)
+{
+    std::map<std::pair<int64_t, int64_t>, int64_t> weights;
+    for (const DynoGraph::Edge& e : edges) { weights[{e.src, e.dst}] += e.weight; }
+    std::vector<std::vector<std::pair<int64_t, int64_t>>> out_edges(nv);
+    for (const auto& w : weights) { out_edges[w.first.first].emplace_back(w.first.second, weighted ? w.second : 1); }
+
+    std::vector<int64_t> distances(nv, -1);
+    std::priority_queue<std::pair<int64_t, int64_t>, std::vector<std::pair<int64_t, int64_t>>,
+        std::greater<std::pair<int64_t, int64_t>>> queue;
+    queue.push({0, source});
+    while (!queue.empty())
+    {
+        auto top = queue.top();
+        queue.pop();
+        if (distances[top.second] != -1) { continue; }
+        distances[top.second] = top.first;
+        for (const auto& e : out_edges[top.second])
+        {
+            if (distances[e.first] == -1) { queue.push({top.first + e.second, e.first}); }
+        }
+    }
+    return distances;
+}
+
+// Make sure SSSP repaired from the previous epoch's tree matches a full traversal,
+// both when edges are added and when deletions cut branches off the tree,
+// and that BFS still writes the mask of sources that reach each vertex
+TEST(BOOST_DYNOGRAPH, IncrementalTraversal)
+{
+    setenv("BOOST_DYNOGRAPH_INCREMENTAL_TRAVERSAL", "1", 1);
+    DynoGraph::Args args;
+    args.input_path = "dynograph_util/data/worldcup-10K.graph.bin";
+    args.alg_names = {"bfs", "sssp"};
+    args.batch_size = 1000;
+    args.num_epochs = 1;
+    args.sort_mode = DynoGraph::Args::SORT_MODE::UNSORTED;
+    args.num_trials = 1;
+    args.num_alg_trials = 1;
+    args.window_size = 1.0;
+    DynoGraph::EdgeListDataset dataset(args);
+    const int64_t nv = dataset.getMaxVertexId() + 1;
+    boost_dynamic_graph graph(args, dataset.getMaxVertexId());
+    unsetenv("BOOST_DYNOGRAPH_INCREMENTAL_TRAVERSAL");
+    auto comm = boost::mpi::communicator();
+
+    std::vector<DynoGraph::Edge> edges;
+    std::vector<int64_t> bfs_data(nv, 0), sssp_data(nv, 0);
+    const int64_t source = dataset.getBatch(0)->begin()->src;
+    auto check_epoch = [&]() {
+        graph.before_algs();
+        graph.update_alg("bfs", {source}, bfs_data);
+        graph.update_alg("sssp", {source}, sssp_data);
+        // Each rank only fills in the results of its own vertices, so combine them before comparing
+        std::vector<int64_t> distances(nv), masks(nv);
+        boost::mpi::all_reduce(comm, sssp_data.data(), nv, distances.data(), std::plus<int64_t>());
+        EXPECT_EQ(reference_distances(edges, nv, source, true), distances);
+        std::vector<int64_t> expected_masks = reference_distances(edges, nv, source, false);
+        for (int64_t& mask : expected_masks) { mask = mask >= 0 ? 1 : 0; }
+        boost::mpi::all_reduce(comm, bfs_data.data(), nv, masks.data(), std::plus<int64_t>());
+        EXPECT_EQ(expected_masks, masks);
+    };
+
+    for (int64_t batch_id = 0; batch_id < 4; ++batch_id)
+    {
+        // Only rank 0 holds the batches, like with the default dataset
+        auto batch = dataset.getBatch(batch_id);
+        edges.insert(edges.end(), batch->begin(), batch->end());
+        graph.insert_batch(comm.rank() == 0 ? *batch : DynoGraph::Batch());
+        check_epoch();
+    }
+
+    // Deleting edges invalidates the parts of the tree below them
+    int64_t threshold = dataset.getBatch(1)->begin()->timestamp;
+    graph.delete_edges_older_than(threshold);
+    edges.erase(std::remove_if(edges.begin(), edges.end(),
+        [&](const DynoGraph::Edge& e) { return e.timestamp < threshold; }), edges.end());
+    check_epoch();
+}
+
+// Serial Brandes over a list of edges, accumulating dependencies from the given sources only
+static std::vector<double>
+reference_bc(const std::vector<DynoGraph::Edge>& edges, int64_t nv, const std::vector<int64_t>& sources)
+{
+    std::set<std::pair<int64_t, int64_t>> unique_edges;
+    for (const DynoGraph::Edge& e : edges) { unique_edges.insert({e.src, e.dst}); }
+    std::vector<std::vector<int64_t>> out_edges(nv);
+    for (const auto& e : unique_edges) { out_edges[e.first].push_back(e.second); }
+
+    std::vector<double> centrality(nv, 0.0);
+    for (int64_t source : sources)
+    {
+        std::vector<int64_t> depth(nv, -1), order;
+        std::vector<double> num_paths(nv, 0.0), dependency(nv, 0.0);
+        std::queue<int64_t> queue;
+        depth[source] = 0;
+        num_paths[source] = 1;
+        queue.push(source);
+        while (!queue.empty())
+        {
+            int64_t u = queue.front();
+            queue.pop();
+            order.push_back(u);
+            for (int64_t v : out_edges[u])
+            {
+                if (depth[v] == -1) { depth[v] = depth[u] + 1; queue.push(v); }
+                if (depth[v] == depth[u] + 1) { num_paths[v] += num_paths[u]; }
+            }
+        }
+        for (auto u = order.rbegin(); u != order.rend(); ++u)
+        {
+            for (int64_t v : out_edges[*u])
+            {
+                if (depth[v] == depth[*u] + 1) { dependency[*u] += num_paths[*u] / num_paths[v] * (1 + dependency[v]); }
+            }
+            if (*u != source) { centrality[*u] += dependency[*u]; }
+        }
+    }
+    return centrality;
+}
+
+// Make sure sampled betweenness centrality matches Brandes' algorithm from the same sources,
+// with more sources than are traversed at the same time
+TEST(BOOST_DYNOGRAPH, SampledBetweennessCentrality)
+{
+    DynoGraph::Args args;
+    args.input_path = "dynograph_util/data/worldcup-10K.graph.bin";
+    args.alg_names = {"bc"};
+    args.batch_size = 2000;
+    args.num_epochs = 1;
+    args.sort_mode = DynoGraph::Args::SORT_MODE::UNSORTED;
+    args.num_trials = 1;
+    args.num_alg_trials = 1;
+    args.window_size = 1.0;
+    DynoGraph::EdgeListDataset dataset(args);
+    const int64_t nv = dataset.getMaxVertexId() + 1;
+    boost_dynamic_graph graph(args, dataset.getMaxVertexId());
+    auto comm = boost::mpi::communicator();
+
+    // Only rank 0 holds the batches, like with the default dataset
+    auto batch = dataset.getBatch(0);
+    std::vector<DynoGraph::Edge> edges(batch->begin(), batch->end());
+    graph.insert_batch(comm.rank() == 0 ? *batch : DynoGraph::Batch());
+    std::vector<int64_t> sources = graph.get_high_degree_vertices(40);
+
+    std::vector<int64_t> data(nv, 0);
+    graph.before_algs();
+    graph.update_alg("bc", sources, data);
+    // Each rank only fills in the centrality of its own vertices, so combine them before comparing
+    std::vector<double> local_centrality(nv), centrality(nv);
+    std::transform(data.begin(), data.end(), local_centrality.begin(), [](int64_t value) {
+        return DynoGraph::from_fixed_point(value, DynoGraph::BC_FIXED_POINT_SCALE);
+    });
+    boost::mpi::all_reduce(comm, local_centrality.data(), nv, centrality.data(), std::plus<double>());
+    std::vector<double> expected = reference_bc(edges, nv, sources);
+    for (int64_t v = 0; v < nv; ++v) { EXPECT_NEAR(expected[v], centrality[v], 1e-6 * (1 + expected[v])); }
+}
+
+// Make sure the multi-source BFS finds the same vertices as a separate traversal from each source,
+// on both the adjacency list and the CSR snapshot
+TEST(BOOST_DYNOGRAPH, MultiSourceBFS)
+{
+    DynoGraph::Args args;
+    args.input_path = "dynograph_util/data/worldcup-10K.graph.bin";
+    args.batch_size = 2000;
+    args.num_epochs = 1;
+    args.sort_mode = DynoGraph::Args::SORT_MODE::UNSORTED;
+    args.num_trials = 1;
+    args.num_alg_trials = 1;
+    args.window_size = 1.0;
+    DynoGraph::EdgeListDataset dataset(args);
+    const int64_t nv = dataset.getMaxVertexId() + 1;
+    Graph graph(nv);
+    auto comm = boost::mpi::communicator();
+
+    auto batch = dataset.getBatch(0);
+    std::vector<DynoGraph::Edge> edges(batch->begin(), batch->end());
+    if (comm.rank() == 0) {
+        for (const DynoGraph::Edge& e : edges) {
+            boost::add_edge(boost::vertex(e.src, graph), boost::vertex(e.dst, graph),
+                Weight(e.weight, Timestamp(e.timestamp)), graph);
+        }
+    }
+    synchronize(graph);
+
+    // Use the first 64 distinct sources in the batch
+    std::vector<int64_t> sources;
+    for (const DynoGraph::Edge& e : edges)
+    {
+        if (sources.size() == 64) { break; }
+        if (std::find(sources.begin(), sources.end(), e.src) == sources.end()) { sources.push_back(e.src); }
+    }
+    std::vector<uint64_t> expected(nv, 0);
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        std::vector<int64_t> distances = reference_distances(edges, nv, sources[i], false);
+        for (int64_t v = 0; v < nv; ++v)
+        {
+            if (distances[v] != -1) { expected[v] |= uint64_t(1) << i; }
+        }
+    }
+    // Each rank only fills in the masks of its own vertices, so combine them before comparing
+    auto check_masks = [&](const std::vector<int64_t>& data) {
+        std::vector<int64_t> masks(nv);
+        boost::mpi::all_reduce(comm, data.data(), nv, masks.data(), std::bit_or<int64_t>());
+        for (int64_t v = 0; v < nv; ++v) { EXPECT_EQ(expected[v], static_cast<uint64_t>(masks[v])); }
+    };
+
+    std::vector<int64_t> data(nv, 0), csr_data(nv, 0);
+    run_multi_source_bfs(graph, sources, data);
+    check_masks(data);
+    local_csr csr;
+    csr.freeze(graph);
+    run_multi_source_bfs(csr, graph, sources, csr_data);
+    check_masks(csr_data);
+}
+
 int main(int argc, char **argv)
 {
     // Initialize MPI
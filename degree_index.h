@@ -0,0 +1,45 @@
+#pragma once
+
+#include <dynograph_util/dynamic_graph.h>
+#include <set>
+#include <vector>
+#include <cinttypes>
+
+/*
+ * Keeps the local vertices with at least one out-edge ordered by out-degree,
+ * so the highest-degree vertices can be listed without sorting the whole vertex set.
+ * Must be told about every degree change with update()
+ */
+class degree_index
+{
+private:
+    typedef DynoGraph::vertex_degree vertex_degree;
+    // Ordered by degree ascending, then by vertex ID descending
+    std::set<vertex_degree> degrees;
+public:
+    // Moves a vertex from one degree to another
+    void
+    update(int64_t vertex_id, int64_t old_degree, int64_t new_degree)
+    {
+        if (old_degree == new_degree) { return; }
+        if (old_degree > 0) { degrees.erase(vertex_degree(vertex_id, old_degree)); }
+        if (new_degree > 0) { degrees.insert(vertex_degree(vertex_id, new_degree)); }
+    }
+
+    // Returns up to n vertices with the highest degree, in order of decreasing degree
+    std::vector<vertex_degree>
+    top(int64_t n) const
+    {
+        std::vector<vertex_degree> result;
+        for (auto v = degrees.rbegin(); v != degrees.rend() && static_cast<int64_t>(result.size()) < n; ++v)
+        {
+            result.push_back(*v);
+        }
+        return result;
+    }
+
+    // Returns the number of vertices with at least one out-edge
+    size_t size() const { return degrees.size(); }
+
+    void clear() { degrees.clear(); }
+};
@@ -1,5 +1,6 @@
 #include "alg_data_manager.h"
 #include "logger.h"
+#include <algorithm>
 #include <stdlib.h>
 #include <stdio.h>
 #include <sys/stat.h>
@@ -14,6 +15,7 @@ AlgDataManager::AlgDataManager(int64_t nv, std::vector<std::string> alg_names)
         last_epoch_data.emplace(make_pair(alg_name, pvector<int64_t>(nv)));
         current_epoch_data.emplace(make_pair(alg_name, pvector<int64_t>(nv)));
     }
+    reset();
 
     path = "";
     if (const char* filename = getenv("DYNOGRAPH_ALG_DATA_PATH"))
@@ -48,6 +50,13 @@ AlgDataManager::rollback()
     }
 }
 
+void
+AlgDataManager::reset()
+{
+    for (auto& entry : last_epoch_data) { std::fill(entry.second.begin(), entry.second.end(), 0); }
+    for (auto& entry : current_epoch_data) { std::fill(entry.second.begin(), entry.second.end(), 0); }
+}
+
 void
 AlgDataManager::dump(int64_t epoch) const
 {
@@ -4,11 +4,23 @@
 #include <string>
 #include <vector>
 #include <cinttypes>
+#include <cmath>
 #include "pvector.h"
 #include "range.h"
 
 namespace DynoGraph {
 
+// Algorithms with fractional results store them in the alg data as fixed-point numbers,
+// so every dumped file holds plain integers: divide by the scale to get the value back
+// PageRank values are at most one, so they can use most of the bits for the fraction
+const double PAGERANK_FIXED_POINT_SCALE = 281474976710656.0; // 2^48
+// Betweenness centrality grows with the number of paths through a vertex, so it keeps more bits for the integer part
+const double BC_FIXED_POINT_SCALE = 1048576.0; // 2^20
+inline int64_t to_fixed_point(double value, double scale) { return std::llround(value * scale); }
+inline double from_fixed_point(int64_t value, double scale) { return value / scale; }
+
+// Holds the results of each algorithm for the current and previous epoch, one value per vertex
+// Results start out as zero, which incremental algorithms take to mean there is no previous result
 class AlgDataManager
 {
 private:
@@ -19,6 +31,8 @@ public:
     AlgDataManager(int64_t nv, std::vector<std::string> alg_names);
     void next_epoch();
     void rollback();
+    // Clear the results of every algorithm, so the next trial starts from scratch
+    void reset();
     void dump(int64_t epoch) const;
     DynoGraph::Range<int64_t> get_data_for_alg(std::string alg_name);
 };
@@ -25,7 +25,7 @@ static const option long_options[] = {
 
 static const std::pair<string, string> option_descriptions[] = {
     {"num-epochs" , "Number of epochs (algorithm updates) in the benchmark"},
-    {"input-path" , "File path to the graph edge list to load (.graph.el or .graph.bin)"},
+    {"input-path" , "File path to the graph edge list to load (.graph.el, .graph.bin, or .graph.cbin)"},
     {"batch-size" , "Number of edges in each batch of insertions"},
     {"alg-names"  , "Algorithms to run in each epoch"},
     {"sort-mode"  , "Controls batch pre-processing: \n"
@@ -41,6 +41,9 @@ Batch::filter(int64_t threshold)
 void
 Batch::dedup_and_sort_by_out_degree()
 {
+    // Nothing to do, and max_vertex_id() is undefined for an empty batch
+    if (size() == 0) { return; }
+
     // Sort to prepare for deduplication
     auto by_src_dest_time = [](const Edge& a, const Edge& b) {
         // Order by src ascending, then dest ascending, then timestamp descending
@@ -106,3 +106,10 @@ TEST(BatchTest, NumVerticesAffected) {
     ASSERT_EQ(batch.num_vertices_affected(), 6);
 }
 
+// Make sure sorting an empty batch doesn't crash (happens on MPI ranks that have no edges)
+TEST(BatchTest, DedupAndSortEmptyBatch) {
+    std::vector<Edge> edges;
+    Batch batch(edges);
+    batch.dedup_and_sort_by_out_degree();
+    EXPECT_EQ(batch.size(), 0);
+}
@@ -2,8 +2,10 @@
 #include "helpers.h"
 #include "rmat_dataset.h"
 #include "edgelist_dataset.h"
+#include "prefetch_dataset.h"
 #ifdef USE_MPI
 #include "proxy_dataset.h"
+#include "distributed_dataset.h"
 #endif
 
 using namespace DynoGraph;
@@ -39,6 +41,24 @@ DynoGraph::create_dataset(const Args &args)
     DynoGraph::Logger& logger = DynoGraph::Logger::get_instance();
 
     shared_ptr<IDataset> dataset(nullptr);
+#ifdef USE_MPI
+    // Every rank reads or generates its own part of each batch, instead of loading everything on rank 0
+    const char* distributed_load = getenv("DYNOGRAPH_DISTRIBUTED_LOAD");
+    if (distributed_load && atoi(distributed_load) != 0) {
+        if (has_suffix(args.input_path, ".graph.bin")) {
+            return make_shared<DistributedDataset>(args);
+        } else if (has_suffix(args.input_path, ".rmat")) {
+            RmatArgs rmat_args(RmatArgs::from_string(args.input_path));
+            std::string msg = rmat_args.validate();
+            if (!msg.empty()) {
+                logger << msg;
+                die();
+            }
+            auto comm = boost::mpi::communicator();
+            return make_shared<RmatDataset>(args, rmat_args, comm.rank(), comm.size());
+        }
+    }
+#endif
     MPI_RANK_0_ONLY {
     if (has_suffix(args.input_path, ".rmat")) {
         // The suffix ".rmat" means we interpret input_path as a list of params, not as a literal path
@@ -51,6 +71,7 @@ DynoGraph::create_dataset(const Args &args)
         dataset = make_shared<RmatDataset>(args, rmat_args);
 
     } else if (has_suffix(args.input_path, ".graph.bin")
+    || has_suffix(args.input_path, ".graph.cbin")
     || has_suffix(args.input_path, ".graph.el"))
     {
         dataset = make_shared<EdgeListDataset>(args);
@@ -59,6 +80,11 @@ DynoGraph::create_dataset(const Args &args)
         logger << "Unrecognized file extension for " << args.input_path << "\n";
         die();
     }
+    // Load batches ahead of time on a helper thread
+    const char* prefetch_depth = getenv("DYNOGRAPH_PREFETCH_BATCHES");
+    if (prefetch_depth && atoi(prefetch_depth) > 0) {
+        dataset = make_shared<PrefetchDataset>(dataset, atoi(prefetch_depth));
+    }
     }
     MPI_BARRIER();
 #ifdef USE_MPI
@@ -119,6 +145,14 @@ DynoGraph::enable_algs_for_batch(int64_t batch_id, int64_t num_batches, int64_t
     return enable;
 }
 
+// Returns true if the next batch should be prepared before the current one is inserted
+bool
+DynoGraph::pipeline_batches()
+{
+    const char* value = getenv("DYNOGRAPH_PIPELINE_BATCHES");
+    return value != NULL && atoi(value) != 0;
+}
+
 std::vector<int64_t>
 DynoGraph::load_sources_from_file(std::string path, int64_t max_vertex_id)
 {
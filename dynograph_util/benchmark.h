@@ -13,6 +13,7 @@
 #include "args.h"
 #include "idataset.h"
 #include "alg_data_manager.h"
+#include "snapshot_builder.h"
 #include "dynamic_graph.h"
 #include "logger.h"
 #include <hooks.h>
@@ -28,6 +29,9 @@ get_preprocessed_batch(int64_t batchId, IDataset &dataset, Args::SORT_MODE sort_
 bool
 enable_algs_for_batch(int64_t batch_id, int64_t num_batches, int64_t num_epochs);
 
+bool
+pipeline_batches();
+
 std::vector<int64_t>
 load_sources_from_file(std::string path, int64_t max_vertex_id);
 
@@ -39,6 +43,8 @@ protected:
     std::shared_ptr<IDataset> dataset;
     int64_t max_vertex_id;
     AlgDataManager alg_data_manager;
+    // Keeps the previous snapshot in snapshot mode, so each epoch only has to merge in the new batches
+    SnapshotBuilder snapshot_builder;
     std::vector<int64_t> sources;
     Logger& logger;
     Hooks& hooks;
@@ -61,18 +67,34 @@ public:
         // Epoch will be incremented as necessary
         int64_t epoch = 0;
         int64_t num_batches = dataset->getNumBatches();
-        for (int64_t batch_id = 0; batch_id < num_batches; ++batch_id)
+        // In pipelined mode, the next batch is handed to the graph before the current one is inserted
+        const bool pipeline = pipeline_batches();
+        std::shared_ptr<DynoGraph::Batch> next_batch;
+        if (pipeline)
         {
-            hooks.set_attr("batch", batch_id);
+            hooks.set_attr("batch", static_cast<int64_t>(0));
             hooks.set_attr("epoch", epoch);
-
-            // Batch preprocessing (preprocess)
             hooks.region_begin("preprocess");
-            std::shared_ptr<DynoGraph::Batch> batch = get_preprocessed_batch(batch_id, *dataset, args.sort_mode);
+            next_batch = get_preprocessed_batch(0, *dataset, args.sort_mode);
+            graph.before_batch(*next_batch, dataset->getTimestampForWindow(0));
             hooks.region_end();
+        }
+        for (int64_t batch_id = 0; batch_id < num_batches; ++batch_id)
+        {
+            hooks.set_attr("batch", batch_id);
+            hooks.set_attr("epoch", epoch);
 
+            std::shared_ptr<DynoGraph::Batch> batch;
             int64_t threshold = dataset->getTimestampForWindow(batch_id);
-            graph.before_batch(*batch, threshold);
+            if (pipeline) {
+                batch = next_batch;
+            } else {
+                // Batch preprocessing (preprocess)
+                hooks.region_begin("preprocess");
+                batch = get_preprocessed_batch(batch_id, *dataset, args.sort_mode);
+                hooks.region_end();
+                graph.before_batch(*batch, threshold);
+            }
 
             // Edge deletion benchmark (deletions)
             if (args.window_size != 1.0)
@@ -85,6 +107,15 @@ public:
                 hooks.region_end();
             }
 
+            // Prepare the next batch, so it can be in flight while this one is inserted
+            if (pipeline && batch_id + 1 < num_batches)
+            {
+                hooks.region_begin("preprocess");
+                next_batch = get_preprocessed_batch(batch_id + 1, *dataset, args.sort_mode);
+                graph.before_batch(*next_batch, dataset->getTimestampForWindow(batch_id + 1));
+                hooks.region_end();
+            }
+
             // Edge insertion benchmark (insertions)
             logger << "Inserting batch " << batch_id << "\n";
             hooks.set_stat("num_vertices", graph.get_num_vertices());
@@ -96,6 +127,7 @@ public:
             // Graph algorithm benchmarks
             if (enable_algs_for_batch(batch_id, num_batches, args.num_epochs))
             {
+                graph.before_algs();
                 for (int64_t alg_trial = 0; alg_trial < args.num_alg_trials; ++alg_trial)
                 {
                     // When we do multiple trials, algs should start with the same data each time
@@ -134,6 +166,7 @@ public:
         assert(epoch == args.num_epochs);
         // Reset dataset for next trial
         dataset->reset();
+        alg_data_manager.reset();
     }
 
     template<typename graph_t>
@@ -157,7 +190,7 @@ public:
 
                 // This batch will be a cumulative, filtered snapshot of all the edges in previous batches
                 hooks.region_begin("preprocess");
-                std::shared_ptr<DynoGraph::Batch> batch = get_preprocessed_batch(batch_id, *dataset, args.sort_mode);
+                std::shared_ptr<DynoGraph::Batch> batch = snapshot_builder.update(batch_id, *dataset);
                 hooks.region_end();
 
                 logger << "Initializing graph for epoch " << epoch << "\n";
@@ -166,6 +199,7 @@ public:
                 hooks.region_begin("construct");
                 graph = new graph_t(args, max_vertex_id, *batch);
                 hooks.region_end();
+                graph->before_algs();
 
                 // Graph algorithm benchmarks
                 for (int64_t alg_trial = 0; alg_trial < args.num_alg_trials; ++alg_trial)
@@ -211,6 +245,8 @@ public:
         assert(epoch == args.num_epochs);
         // Reset dataset for next trial
         dataset->reset();
+        alg_data_manager.reset();
+        snapshot_builder.reset();
     }
 
     template<typename graph_t>
@@ -0,0 +1,16 @@
+#include "compressed_edges.h"
+#include "logger.h"
+
+using namespace DynoGraph;
+
+// Converts a .graph.bin file on stdin to a .graph.cbin file on stdout
+int main(int argc, const char* argv[])
+{
+    Logger& logger = Logger::get_instance();
+    if (!write_compressed_edges(stdin, stdout))
+    {
+        logger << "Failed to convert edges\n";
+        die();
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include "compressed_edges.h"
+#include <string.h>
+
+using namespace DynoGraph;
+
+namespace {
+
+// Map signed integers to unsigned so that values near zero have short encodings
+inline uint64_t
+zigzag_encode(int64_t x)
+{
+    return (static_cast<uint64_t>(x) << 1) ^ static_cast<uint64_t>(x >> 63);
+}
+
+inline int64_t
+zigzag_decode(uint64_t x)
+{
+    return static_cast<int64_t>(x >> 1) ^ -static_cast<int64_t>(x & 1);
+}
+
+inline void
+put_varint(int64_t value, std::vector<uint8_t>& out)
+{
+    uint64_t x = zigzag_encode(value);
+    while (x >= 0x80) {
+        out.push_back(static_cast<uint8_t>(x) | 0x80);
+        x >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(x));
+}
+
+// Returns false if the varint runs past the end of the buffer or is longer than 64 bits
+inline bool
+get_varint(const uint8_t*& pos, const uint8_t* end, int64_t& value)
+{
+    uint64_t x = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (pos == end) { return false; }
+        uint8_t byte = *pos++;
+        x |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (byte < 0x80) {
+            value = zigzag_decode(x);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // end anonymous namespace
+
+void
+DynoGraph::encode_edge_block(const Edge* begin, const Edge* end, std::vector<uint8_t>& out)
+{
+    int64_t prev_timestamp = 0;
+    for (const Edge* e = begin; e < end; ++e)
+    {
+        put_varint(e->src, out);
+        put_varint(e->dst, out);
+        put_varint(e->weight, out);
+        put_varint(e->timestamp - prev_timestamp, out);
+        prev_timestamp = e->timestamp;
+    }
+}
+
+bool
+DynoGraph::decode_edge_block(const uint8_t* begin, const uint8_t* end, int64_t num_edges, Edge* out)
+{
+    const uint8_t* pos = begin;
+    int64_t prev_timestamp = 0;
+    for (int64_t i = 0; i < num_edges; ++i)
+    {
+        Edge& e = out[i];
+        int64_t delta;
+        if (!get_varint(pos, end, e.src)
+         || !get_varint(pos, end, e.dst)
+         || !get_varint(pos, end, e.weight)
+         || !get_varint(pos, end, delta))
+        {
+            return false;
+        }
+        e.timestamp = prev_timestamp + delta;
+        prev_timestamp = e.timestamp;
+    }
+    // Every byte in the block should have been used
+    return pos == end;
+}
+
+bool
+DynoGraph::read_compressed_index(const uint8_t* file, size_t file_size,
+    compressed_footer& footer, const uint64_t*& block_offsets)
+{
+    if (file_size < sizeof(footer)) { return false; }
+    memcpy(&footer, file + file_size - sizeof(footer), sizeof(footer));
+    const int64_t edges_per_block = footer.edges_per_block;
+    if (memcmp(footer.magic, COMPRESSED_MAGIC, sizeof(footer.magic)) != 0
+     || footer.version != COMPRESSED_VERSION
+     || edges_per_block == 0 || footer.num_edges < 0
+     || footer.num_blocks != (footer.num_edges + edges_per_block - 1) / edges_per_block)
+    {
+        return false;
+    }
+
+    // The index must fit between the start of the file and the footer
+    const size_t max_index_entries = (file_size - sizeof(footer)) / sizeof(uint64_t);
+    if (static_cast<uint64_t>(footer.num_blocks) + 1 > max_index_entries) { return false; }
+    const size_t index_begin = file_size - sizeof(footer) - (footer.num_blocks + 1) * sizeof(uint64_t);
+    if (index_begin % sizeof(uint64_t) != 0) { return false; }
+    block_offsets = reinterpret_cast<const uint64_t*>(file + index_begin);
+
+    // Offsets can't decrease, and the last block must end before the index
+    if (block_offsets[0] != 0) { return false; }
+    for (int64_t block = 0; block < footer.num_blocks; ++block)
+    {
+        if (block_offsets[block] > block_offsets[block + 1]) { return false; }
+    }
+    return block_offsets[footer.num_blocks] <= index_begin;
+}
+
+bool
+DynoGraph::write_compressed_edges(FILE* in, FILE* out, uint32_t edges_per_block)
+{
+    // Encode and write one block at a time, keeping only the index in memory
+    std::vector<Edge> edges(edges_per_block);
+    std::vector<uint8_t> block;
+    std::vector<uint64_t> block_offsets = {0};
+    int64_t num_edges = 0;
+    while (size_t rc = fread(edges.data(), sizeof(Edge), edges_per_block, in))
+    {
+        block.clear();
+        encode_edge_block(edges.data(), edges.data() + rc, block);
+        if (fwrite(block.data(), sizeof(uint8_t), block.size(), out) != block.size()) { return false; }
+        block_offsets.push_back(block_offsets.back() + block.size());
+        num_edges += rc;
+    }
+    if (ferror(in)) { return false; }
+
+    compressed_footer footer;
+    memcpy(footer.magic, COMPRESSED_MAGIC, sizeof(footer.magic));
+    footer.version = COMPRESSED_VERSION;
+    footer.edges_per_block = edges_per_block;
+    footer.num_edges = num_edges;
+    footer.num_blocks = block_offsets.size() - 1;
+
+    // Pad the data so the index is aligned
+    const uint8_t padding[sizeof(uint64_t)] = {0};
+    const size_t padding_size = (sizeof(uint64_t) - block_offsets.back() % sizeof(uint64_t)) % sizeof(uint64_t);
+    return fwrite(padding, sizeof(uint8_t), padding_size, out) == padding_size
+        && fwrite(block_offsets.data(), sizeof(uint64_t), block_offsets.size(), out) == block_offsets.size()
+        && fwrite(&footer, sizeof(footer), 1, out) == 1;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "edge.h"
+#include <cinttypes>
+#include <stdio.h>
+#include <vector>
+
+namespace DynoGraph {
+
+/*
+ * Compressed binary edge list format (.graph.cbin)
+ *
+ * Edges are divided into fixed-size blocks, which are encoded independently so they can be decoded in parallel,
+ * or one at a time to read any range of edges without decoding the rest of the file.
+ * Within a block, each field is stored as a zigzag-encoded LEB128 varint: vertex ids and weights as is,
+ * and timestamps as the difference from the previous edge (the first edge of a block stores the full timestamp).
+ * Since timestamps never decrease and most weights are 1, a typical edge takes 8-10 bytes instead of 32.
+ *
+ * Layout:
+ *     block data, padded to a multiple of 8 bytes
+ *     uint64_t block_offsets[num_blocks + 1]   (byte offset of each block from the start of the file)
+ *     compressed_footer
+ *
+ * The index goes at the end so the file can be written in one pass without knowing the number of edges up front.
+ */
+struct compressed_footer
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t edges_per_block;
+    int64_t num_edges;
+    int64_t num_blocks;
+};
+
+const char COMPRESSED_MAGIC[8] = {'D', 'Y', 'N', 'O', 'C', 'B', 'I', 'N'};
+const uint32_t COMPRESSED_VERSION = 1;
+const uint32_t COMPRESSED_EDGES_PER_BLOCK = 1 << 16;
+
+// Appends the encoding of the edges in [begin, end) to out
+void encode_edge_block(const Edge* begin, const Edge* end, std::vector<uint8_t>& out);
+
+// Decodes num_edges edges from [begin, end) into out
+// Returns false if the block is truncated or malformed
+bool decode_edge_block(const uint8_t* begin, const uint8_t* end, int64_t num_edges, Edge* out);
+
+// Checks the footer and block index of a compressed file that has been loaded into memory
+// On success, copies the footer and points block_offsets at the index
+// Returns false if the footer is invalid, or if any block lies outside the data section
+bool read_compressed_index(const uint8_t* file, size_t file_size,
+    compressed_footer& footer, const uint64_t*& block_offsets);
+
+// Reads .graph.bin edges from in until EOF, and writes them to out in compressed format
+// Only one block is held in memory at a time
+// Returns false if an I/O error occurs
+bool write_compressed_edges(FILE* in, FILE* out, uint32_t edges_per_block = COMPRESSED_EDGES_PER_BLOCK);
+
+} // end namespace DynoGraph
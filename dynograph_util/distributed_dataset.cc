@@ -0,0 +1,246 @@
+#include "distributed_dataset.h"
+#include "helpers.h"
+#include "logger.h"
+
+#ifdef USE_MPI
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <algorithm>
+
+using namespace DynoGraph;
+using std::shared_ptr;
+using std::make_shared;
+
+namespace {
+
+// Reads num_edges edges, starting at edge first_edge in the file, into buffer
+void
+read_edges(int fd, const string& path, int64_t first_edge, int64_t num_edges, Edge* buffer)
+{
+    char* dst = reinterpret_cast<char*>(buffer);
+    size_t remaining = num_edges * sizeof(Edge);
+    off_t offset = first_edge * sizeof(Edge);
+    // pread may return fewer bytes than requested, so keep reading until done
+    while (remaining > 0)
+    {
+        ssize_t rc = pread(fd, dst, remaining, offset);
+        if (rc <= 0)
+        {
+            std::cerr << "[DynoGraph] Failed to read edges from " << path << "\n";
+            die();
+        }
+        dst += rc;
+        offset += rc;
+        remaining -= rc;
+    }
+}
+
+} // end anonymous namespace
+
+DistributedDataset::DistributedDataset(Args args)
+        : args(args), directed(true)
+{
+    Logger &logger = Logger::get_instance();
+    if (!has_suffix(args.input_path, ".graph.bin")) {
+        logger << "Distributed loading requires a .graph.bin file, got " << args.input_path << "\n";
+        die();
+    }
+
+    loadLocalSlices(args.input_path);
+    auto comm = boost::mpi::communicator();
+
+    // Calculate max vertex id so engines can statically provision the vertex array
+    int64_t local_max_vertex_id = 0;
+    if (!local_edges.empty()) {
+        local_max_vertex_id = Batch(local_edges).max_vertex_id();
+    }
+    boost::mpi::all_reduce(comm, local_max_vertex_id, max_vertex_id, boost::mpi::maximum<int64_t>());
+
+    // Make sure there are no self-edges
+    bool local_self_edge = std::any_of(local_edges.begin(), local_edges.end(),
+            [](const Edge& e) { return e.src == e.dst; });
+    bool self_edge;
+    boost::mpi::all_reduce(comm, local_self_edge, self_edge, std::logical_or<bool>());
+    if (self_edge) {
+        logger << "Invalid dataset: no self-edges allowed\n";
+        die();
+    }
+
+    // The last edge of every batch belongs to the last rank, which shares the batch end timestamps with everyone
+    batch_end_timestamps.resize(num_batches);
+    const int last_rank = comm.size() - 1;
+    if (comm.rank() == last_rank)
+    {
+        for (int64_t batchId = 0; batchId < num_batches; ++batchId) {
+            batch_end_timestamps[batchId] = local_edges[local_offsets[batchId + 1] - 1].timestamp;
+        }
+    }
+    boost::mpi::broadcast(comm, batch_end_timestamps.data(), num_batches, last_rank);
+}
+
+int64_t
+DistributedDataset::sliceBegin(int64_t batchId, int rank) const
+{
+    const int num_ranks = boost::mpi::communicator().size();
+    return batchId * args.batch_size + (rank * args.batch_size) / num_ranks;
+}
+
+void
+DistributedDataset::loadLocalSlices(string path)
+{
+    Logger &logger = Logger::get_instance();
+    auto comm = boost::mpi::communicator();
+    const int rank = comm.rank();
+    const int num_ranks = comm.size();
+
+    logger << "Checking file size of " << path << "...\n";
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        std::cerr << "[DynoGraph] Failed to open " << path << "\n";
+        die();
+    }
+    num_edges = st.st_size / sizeof(Edge);
+
+    // Same sanity checks as EdgeListDataset, every rank reaches the same decision
+    if (args.batch_size > num_edges)
+    {
+        logger << "Invalid arguments: batch size (" << args.batch_size << ") "
+               << "cannot be larger than the total number of edges in the dataset "
+               << " (" << num_edges << ")\n";
+        die();
+    }
+    // Intentionally rounding down to make it divide evenly
+    num_batches = num_edges / args.batch_size;
+    if (args.num_epochs > num_batches)
+    {
+        logger << "Invalid arguments: number of epochs (" << args.num_epochs << ") "
+               << "cannot be greater than the number of batches in the dataset "
+               << "(" << num_batches << ")\n";
+        die();
+    }
+
+    // Compute the position of each local slice
+    local_offsets.resize(num_batches + 1);
+    local_offsets[0] = 0;
+    for (int64_t batchId = 0; batchId < num_batches; ++batchId)
+    {
+        int64_t slice_size = sliceBegin(batchId, rank + 1) - sliceBegin(batchId, rank);
+        local_offsets[batchId + 1] = local_offsets[batchId] + slice_size;
+    }
+    // The edges after the last full batch are never inserted, but the last rank reads them for validation
+    const int64_t first_leftover = num_batches * args.batch_size;
+    int64_t num_leftover = rank == num_ranks - 1 ? num_edges - first_leftover : 0;
+
+    string directedStr = directed ? "directed" : "undirected";
+    logger << "Preloading " << num_edges << " "
+           << directedStr
+           << " edges from " << path << " on " << num_ranks << " ranks...\n";
+
+    local_edges.resize(local_offsets.back() + num_leftover);
+    bool local_sorted = true;
+    auto by_timestamp = [](const Edge& a, const Edge& b) { return a.timestamp < b.timestamp; };
+    for (int64_t batchId = 0; batchId < num_batches; ++batchId)
+    {
+        int64_t slice_begin = sliceBegin(batchId, rank);
+        int64_t slice_size = local_offsets[batchId + 1] - local_offsets[batchId];
+        if (slice_size == 0) { continue; }
+        Edge* slice = &local_edges[local_offsets[batchId]];
+        read_edges(fd, path, slice_begin, slice_size, slice);
+
+        // Check the slice is sorted, including the boundary with the next edge in the file
+        local_sorted = local_sorted && std::is_sorted(slice, slice + slice_size, by_timestamp);
+        int64_t next = slice_begin + slice_size;
+        if (next < num_edges)
+        {
+            Edge next_edge;
+            read_edges(fd, path, next, 1, &next_edge);
+            local_sorted = local_sorted && !by_timestamp(next_edge, slice[slice_size - 1]);
+        }
+    }
+    if (num_leftover > 0)
+    {
+        Edge* leftover = &local_edges[local_offsets.back()];
+        read_edges(fd, path, first_leftover, num_leftover, leftover);
+        local_sorted = local_sorted && std::is_sorted(leftover, leftover + num_leftover, by_timestamp);
+    }
+
+    // Make sure edges are sorted by timestamp
+    bool sorted;
+    boost::mpi::all_reduce(comm, local_sorted, sorted, std::logical_and<bool>());
+    if (!sorted)
+    {
+        logger << "Invalid dataset: edges not sorted by timestamp\n";
+        die();
+    }
+
+    // The first and last edges in the file give the timestamp range
+    Edge first_edge, last_edge;
+    read_edges(fd, path, 0, 1, &first_edge);
+    read_edges(fd, path, num_edges - 1, 1, &last_edge);
+    min_timestamp = first_edge.timestamp;
+    max_timestamp = last_edge.timestamp;
+    close(fd);
+}
+
+int64_t
+DistributedDataset::getTimestampForWindow(int64_t batchId) const
+{
+    // Calculate width of timestamp window
+    int64_t window_time = round_down(args.window_size * (max_timestamp - min_timestamp));
+    // Get the timestamp of the last edge in the current batch
+    int64_t latest_time = batch_end_timestamps[batchId];
+    return std::max(min_timestamp, latest_time - window_time);
+}
+
+shared_ptr<Batch>
+DistributedDataset::getBatch(int64_t batchId)
+{
+    Edge* begin = local_edges.data();
+    return make_shared<Batch>(begin + local_offsets[batchId], begin + local_offsets[batchId + 1]);
+}
+
+shared_ptr<Batch>
+DistributedDataset::getBatchesUpTo(int64_t batchId)
+{
+    // The local slices are stored in batch order, so they are still sorted by timestamp
+    Edge* begin = local_edges.data();
+    return make_shared<Batch>(begin, begin + local_offsets[batchId + 1]);
+}
+
+bool
+DistributedDataset::isDirected() const
+{
+    return directed;
+}
+
+int64_t
+DistributedDataset::getMaxVertexId() const
+{
+    return max_vertex_id;
+}
+
+int64_t
+DistributedDataset::getNumBatches() const {
+    return num_batches;
+}
+
+int64_t
+DistributedDataset::getNumEdges() const {
+    return num_edges;
+}
+
+int64_t
+DistributedDataset::getMinTimestamp() const {
+    return min_timestamp;
+}
+
+int64_t
+DistributedDataset::getMaxTimestamp() const {
+    return max_timestamp;
+}
+
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include "args.h"
+#include "batch.h"
+#include "idataset.h"
+#include "pvector.h"
+
+namespace DynoGraph {
+
+/*
+ * Loads a .graph.bin file in parallel, without ever holding the whole file in one process.
+ * Each batch is divided into equal contiguous slices, and every rank reads its own slice of each batch
+ * straight from the file. Only metadata (max vertex ID, timestamps, validation results) is shared between ranks.
+ *
+ * getBatch and getBatchesUpTo return only this rank's slices, so the graph implementation must be able to
+ * accept updates on any rank and send them where they belong.
+ */
+class DistributedDataset : public IDataset
+{
+private:
+    void loadLocalSlices(std::string path);
+    // Index of the first edge in the file that belongs to a rank's slice of a batch
+    int64_t sliceBegin(int64_t batchId, int rank) const;
+
+    Args args;
+    bool directed;
+    int64_t num_edges;
+    int64_t num_batches;
+    int64_t max_vertex_id;
+    int64_t min_timestamp;
+    int64_t max_timestamp;
+    // Timestamp of the last edge in each batch
+    std::vector<int64_t> batch_end_timestamps;
+
+    // Local slice of each batch, stored in batch order
+    pvector<Edge> local_edges;
+    // Position of each batch's slice within local_edges, plus one past the end
+    std::vector<int64_t> local_offsets;
+
+public:
+    DistributedDataset(Args args);
+
+    int64_t getTimestampForWindow(int64_t batchId) const;
+    std::shared_ptr<Batch> getBatch(int64_t batchId);
+    std::shared_ptr<Batch> getBatchesUpTo(int64_t batchId);
+    int64_t getNumBatches() const;
+    int64_t getNumEdges() const;
+    int64_t getMinTimestamp() const;
+    int64_t getMaxTimestamp() const;
+
+    bool isDirected() const;
+    int64_t getMaxVertexId() const;
+};
+
+} // end namespace DynoGraph
@@ -19,11 +19,15 @@ public:
     // Return list of supported algs - your class must implement this method
     static std::vector<std::string> get_supported_algs();
     // Prepare to insert the batch
+    // In pipelined mode this is called for the next batch before the current one is inserted,
+    // but batches are always inserted in the same order they are passed to before_batch
     virtual void before_batch(const Batch& batch, int64_t threshold) = 0;
     // Delete edges in the graph with a timestamp older than <threshold>
     virtual void delete_edges_older_than(int64_t threshold) = 0;
     // Insert the batch of edges into the graph
     virtual void insert_batch(const Batch& batch) = 0;
+    // Prepare to run algorithms on the current state of the graph
+    virtual void before_algs() {}
     // Run the specified algorithm
     virtual void update_alg(
             // Name of algorithm to run
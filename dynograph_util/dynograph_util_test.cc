@@ -3,10 +3,15 @@
 
 #include "reference_impl.h"
 #include "edgelist_dataset.h"
+#include "compressed_edges.h"
+#include "prefetch_dataset.h"
+#include "rmat_dataset.h"
+#include "snapshot_builder.h"
 #include "benchmark.h"
 #include <gtest/gtest.h>
 #include "pvector.h"
 #include <fstream>
+#include <map>
 #include <iostream>
 
 using namespace DynoGraph;
@@ -43,6 +48,7 @@ public:
         Args args;
         args.input_path = "data/worldcup-10K.graph.bin";
         args.num_trials = 1;
+        args.num_alg_trials = 1;
         args.sort_mode = Args::SORT_MODE::UNSORTED;
         args.alg_names = {};
 
@@ -121,6 +127,7 @@ public:
         args.input_path = "data/worldcup-10K.graph.bin";
         args.num_epochs = 1;
         args.num_trials = 1;
+        args.num_alg_trials = 1;
         args.alg_names = {};
 
         for (int64_t batch_size : { 100, 500, 5000 }) {
@@ -209,6 +216,309 @@ TEST_P(SortModeTest, SortModeDoesntAffectEdgeCount)
     }
 }
 
+// Make sure a memory-mapped dataset returns the same batches as one read into memory
+TEST(DynoGraphUtilTests, MappedDatasetMatchesLoaded)
+{
+    Args args = {1, "data/worldcup-10K.graph.bin", 1000, {}, Args::SORT_MODE::UNSORTED, 0.5, 1};
+    EdgeListDataset loaded(args);
+    setenv("DYNOGRAPH_MMAP", "sequential", 1);
+    EdgeListDataset mapped(args);
+    unsetenv("DYNOGRAPH_MMAP");
+
+    ASSERT_EQ(loaded.getNumBatches(), mapped.getNumBatches());
+    EXPECT_EQ(loaded.getNumEdges(), mapped.getNumEdges());
+    EXPECT_EQ(loaded.getMaxVertexId(), mapped.getMaxVertexId());
+    EXPECT_EQ(loaded.getMinTimestamp(), mapped.getMinTimestamp());
+    EXPECT_EQ(loaded.getMaxTimestamp(), mapped.getMaxTimestamp());
+    for (int64_t i = 0; i < loaded.getNumBatches(); ++i)
+    {
+        EXPECT_EQ(loaded.getTimestampForWindow(i), mapped.getTimestampForWindow(i));
+        auto expected = loaded.getBatch(i);
+        auto actual = mapped.getBatch(i);
+        ASSERT_EQ(expected->size(), actual->size());
+        EXPECT_TRUE(std::equal(expected->begin(), expected->end(), actual->begin()));
+    }
+    auto all_expected = loaded.getBatchesUpTo(loaded.getNumBatches() - 1);
+    auto all_actual = mapped.getBatchesUpTo(mapped.getNumBatches() - 1);
+    ASSERT_EQ(all_expected->size(), all_actual->size());
+    EXPECT_TRUE(std::equal(all_expected->begin(), all_expected->end(), all_actual->begin()));
+}
+
+// Make sure the text and binary versions of a graph load the same edges
+TEST(DynoGraphUtilTests, TextDatasetMatchesBinary)
+{
+    Args args = {1, "data/ring-of-cliques.graph.bin", 10, {}, Args::SORT_MODE::UNSORTED, 1.0, 1};
+    EdgeListDataset binary(args);
+    args.input_path = "data/ring-of-cliques.graph.el";
+    EdgeListDataset text(args);
+
+    auto expected = binary.getBatchesUpTo(binary.getNumBatches() - 1);
+    auto actual = text.getBatchesUpTo(text.getNumBatches() - 1);
+    ASSERT_EQ(binary.getNumEdges(), text.getNumEdges());
+    ASSERT_EQ(expected->size(), actual->size());
+    EXPECT_TRUE(std::equal(expected->begin(), expected->end(), actual->begin()));
+}
+
+// Make sure malformed text inputs are rejected with the line number of the error
+TEST(DynoGraphUtilTests, TextDatasetReportsParseErrors)
+{
+    std::string temp_filename = "test_parse_error.graph.el";
+    std::ofstream temp_file(temp_filename);
+    temp_file << "1 2 1 100\r\n\n3 4 1 101\n5 6 x 102\n7 8 1 103";
+    temp_file.close();
+    Args args = {1, temp_filename, 1, {}, Args::SORT_MODE::UNSORTED, 1.0, 1};
+    EXPECT_EXIT(EdgeListDataset dataset(args), ::testing::ExitedWithCode(255), "line 4");
+    remove(temp_filename.c_str());
+}
+
+// Make sure integers that don't fit in 64 bits are rejected instead of wrapping around
+TEST(DynoGraphUtilTests, TextDatasetRejectsOverflow)
+{
+    std::string temp_filename = "test_overflow.graph.el";
+    std::ofstream temp_file(temp_filename);
+    temp_file << "1 2 -9223372036854775808 9223372036854775807\n3 4 1 9999999999999999999\n";
+    temp_file.close();
+    Args args = {1, temp_filename, 1, {}, Args::SORT_MODE::UNSORTED, 1.0, 1};
+    EXPECT_EXIT(EdgeListDataset dataset(args), ::testing::ExitedWithCode(255), "line 2");
+    remove(temp_filename.c_str());
+}
+
+// Make sure a compressed dataset loads the same edges as the binary file it was converted from
+TEST(DynoGraphUtilTests, CompressedDatasetMatchesBinary)
+{
+    std::string bin_filename = "data/worldcup-10K.graph.bin";
+    std::string temp_filename = "test_compressed.graph.cbin";
+    FILE* in = fopen(bin_filename.c_str(), "rb");
+    FILE* out = fopen(temp_filename.c_str(), "wb");
+    ASSERT_TRUE(in && out);
+    // Use small blocks that don't line up with the batches, so batches span several blocks
+    ASSERT_TRUE(write_compressed_edges(in, out, 777));
+    fclose(in);
+    fclose(out);
+
+    Args args = {1, bin_filename, 1000, {}, Args::SORT_MODE::UNSORTED, 0.5, 1};
+    EdgeListDataset binary(args);
+    args.input_path = temp_filename;
+    EdgeListDataset compressed(args);
+    ASSERT_EQ(binary.getNumEdges(), compressed.getNumEdges());
+    ASSERT_EQ(binary.getNumBatches(), compressed.getNumBatches());
+    EXPECT_EQ(binary.getMaxVertexId(), compressed.getMaxVertexId());
+
+    // Batches are decoded independently, in any order
+    for (int64_t i = binary.getNumBatches() - 1; i >= 0; i -= 3)
+    {
+        auto expected = binary.getBatch(i);
+        auto actual = compressed.getBatch(i);
+        ASSERT_EQ(expected->size(), actual->size());
+        EXPECT_TRUE(std::equal(expected->begin(), expected->end(), actual->begin())) << "Batch " << i << " differs";
+        EXPECT_EQ(binary.getTimestampForWindow(i), compressed.getTimestampForWindow(i));
+    }
+    auto expected = binary.getBatchesUpTo(binary.getNumBatches() - 1);
+    auto actual = compressed.getBatchesUpTo(compressed.getNumBatches() - 1);
+    ASSERT_EQ(expected->size(), actual->size());
+    EXPECT_TRUE(std::equal(expected->begin(), expected->end(), actual->begin()));
+
+    // The compressed file should be much smaller
+    std::ifstream bin_file(bin_filename, std::ios::binary | std::ios::ate);
+    std::ifstream compressed_file(temp_filename, std::ios::binary | std::ios::ate);
+    EXPECT_LT(compressed_file.tellg() * 2, bin_file.tellg());
+    remove(temp_filename.c_str());
+}
+
+// Make sure a block offset that points outside the file is rejected before anything is decoded
+TEST(DynoGraphUtilTests, CompressedDatasetRejectsBadIndex)
+{
+    std::string temp_filename = "test_bad_index.graph.cbin";
+    FILE* in = fopen("data/worldcup-10K.graph.bin", "rb");
+    FILE* out = fopen(temp_filename.c_str(), "wb");
+    ASSERT_TRUE(in && out);
+    ASSERT_TRUE(write_compressed_edges(in, out, 1000));
+    fclose(in);
+    fclose(out);
+
+    // Overwrite the offset of the second block in the index
+    {
+        std::fstream file(temp_filename, std::ios::binary | std::ios::in | std::ios::out);
+        compressed_footer footer;
+        file.seekg(-static_cast<std::streamoff>(sizeof(footer)), std::ios::end);
+        file.read(reinterpret_cast<char*>(&footer), sizeof(footer));
+        ASSERT_GT(footer.num_blocks, 2);
+        // The index has num_blocks + 1 entries and ends at the footer
+        std::streamoff second_entry = sizeof(footer) + footer.num_blocks * sizeof(uint64_t);
+        file.seekp(-second_entry, std::ios::end);
+        uint64_t bad_offset = 1ULL << 40;
+        file.write(reinterpret_cast<const char*>(&bad_offset), sizeof(bad_offset));
+    }
+    Args args = {1, temp_filename, 1000, {}, Args::SORT_MODE::UNSORTED, 0.5, 1};
+    EXPECT_EXIT(EdgeListDataset dataset(args), ::testing::ExitedWithCode(255), "Invalid compressed edge list index");
+    remove(temp_filename.c_str());
+}
+
+// Make sure the parallel validation scan finds invalid edges anywhere in the dataset, including between blocks
+TEST(DynoGraphUtilTests, ValidationRejectsInvalidEdges)
+{
+    std::string bin_filename = "test_validation.graph.bin";
+    std::string temp_filename = "test_validation.graph.cbin";
+    auto write_dataset = [&](const std::vector<Edge>& edges) {
+        FILE* bin = fopen(bin_filename.c_str(), "w+b");
+        FILE* out = fopen(temp_filename.c_str(), "wb");
+        ASSERT_TRUE(bin && out);
+        ASSERT_EQ(edges.size(), fwrite(edges.data(), sizeof(Edge), edges.size(), bin));
+        rewind(bin);
+        ASSERT_TRUE(write_compressed_edges(bin, out, 100));
+        fclose(bin);
+        fclose(out);
+    };
+    std::vector<Edge> edges(1000);
+    for (int64_t i = 0; i < 1000; ++i) { edges[i] = {i % 37, i % 37 + 1, 1, i}; }
+    Args args = {1, temp_filename, 100, {}, Args::SORT_MODE::UNSORTED, 1.0, 1};
+
+    write_dataset(edges);
+    {
+        EdgeListDataset dataset(args);
+        EXPECT_EQ(37, dataset.getMaxVertexId());
+        EXPECT_EQ(0, dataset.getMinTimestamp());
+        EXPECT_EQ(999, dataset.getMaxTimestamp());
+    }
+
+    // Out of order only across the boundary between two blocks
+    std::vector<Edge> unsorted(edges);
+    for (int64_t i = 500; i < 1000; ++i) { unsorted[i].timestamp -= 2; }
+    write_dataset(unsorted);
+    EXPECT_EXIT(EdgeListDataset dataset(args), ::testing::ExitedWithCode(255), "not sorted");
+
+    std::vector<Edge> self_edge(edges);
+    self_edge[750].dst = self_edge[750].src;
+    write_dataset(self_edge);
+    EXPECT_EXIT(EdgeListDataset dataset(args), ::testing::ExitedWithCode(255), "self-edges");
+
+    remove(bin_filename.c_str());
+    remove(temp_filename.c_str());
+}
+
+// Make sure the sidecar metadata file is written once, then reused, and ignored when corrupt
+TEST(DynoGraphUtilTests, DatasetMetadataIsReused)
+{
+    std::string temp_filename = "test_metadata.graph.bin";
+    std::string meta_filename = temp_filename + ".meta";
+    {
+        std::ifstream src("data/worldcup-10K.graph.bin", std::ios::binary);
+        std::ofstream dst(temp_filename, std::ios::binary);
+        dst << src.rdbuf();
+    }
+    remove(meta_filename.c_str());
+    setenv("DYNOGRAPH_DATASET_META", "1", 1);
+    Args args = {1, temp_filename, 1000, {}, Args::SORT_MODE::UNSORTED, 0.5, 1};
+
+    auto check_same = [](const EdgeListDataset& a, const EdgeListDataset& b) {
+        EXPECT_EQ(a.getMaxVertexId(), b.getMaxVertexId());
+        EXPECT_EQ(a.getMinTimestamp(), b.getMinTimestamp());
+        EXPECT_EQ(a.getMaxTimestamp(), b.getMaxTimestamp());
+        for (int64_t i = 0; i < a.getNumBatches(); ++i) {
+            EXPECT_EQ(a.getTimestampForWindow(i), b.getTimestampForWindow(i));
+        }
+    };
+
+    // First load validates the edges and writes the metadata
+    EdgeListDataset validated(args);
+    EXPECT_TRUE(std::ifstream(meta_filename).good());
+
+    // Second load uses the metadata
+    testing::internal::CaptureStderr();
+    EdgeListDataset cached(args);
+    EXPECT_NE(testing::internal::GetCapturedStderr().find("skipping validation"), std::string::npos);
+    check_same(validated, cached);
+
+    // Corrupt metadata is ignored
+    {
+        std::fstream meta(meta_filename, std::ios::binary | std::ios::in | std::ios::out);
+        meta.seekp(40);
+        meta.put('\x7f');
+    }
+    testing::internal::CaptureStderr();
+    EdgeListDataset revalidated(args);
+    EXPECT_NE(testing::internal::GetCapturedStderr().find("Ignoring invalid metadata"), std::string::npos);
+    check_same(validated, revalidated);
+
+    unsetenv("DYNOGRAPH_DATASET_META");
+    remove(temp_filename.c_str());
+    remove(meta_filename.c_str());
+}
+
+// Make sure prefetched batches are the same as the ones loaded on demand, even when accessed out of order
+TEST(DynoGraphUtilTests, PrefetchedBatchesMatch)
+{
+    Args args = {1, "0.55-0.20-0.10-0.15-44500-8K.rmat", 500, {}, Args::SORT_MODE::UNSORTED, 1.0, 1};
+    RmatArgs rmat_args = RmatArgs::from_string(args.input_path);
+    RmatDataset expected(args, rmat_args);
+    PrefetchDataset actual(std::make_shared<RmatDataset>(args, rmat_args), 3);
+    ASSERT_EQ(expected.getNumBatches(), actual.getNumBatches());
+
+    auto check_batch = [&](int64_t batch_id) {
+        auto a = expected.getBatch(batch_id);
+        auto b = actual.getBatch(batch_id);
+        ASSERT_EQ(a->size(), b->size());
+        EXPECT_TRUE(std::equal(a->begin(), a->end(), b->begin())) << "Batch " << batch_id << " differs";
+    };
+
+    // In order
+    for (int64_t i = 0; i < 10; ++i) { check_batch(i); }
+    // Skip ahead
+    check_batch(20);
+    check_batch(21);
+    // Go back
+    check_batch(5);
+    check_batch(6);
+    // Mixed with cumulative batches
+    auto a = expected.getBatchesUpTo(7);
+    auto b = actual.getBatchesUpTo(7);
+    ASSERT_EQ(a->size(), b->size());
+    EXPECT_TRUE(std::equal(a->begin(), a->end(), b->begin()));
+    check_batch(8);
+    // After reset
+    expected.reset();
+    actual.reset();
+    for (int64_t i = 0; i < expected.getNumBatches(); ++i) { check_batch(i); }
+}
+
+// Make sure the incremental snapshot has the same edges as sorting all previous batches from scratch
+TEST(DynoGraphUtilTests, IncrementalSnapshotMatches)
+{
+    auto by_pair = [](const Edge& a, const Edge& b) {
+        return (a.src != b.src) ? a.src < b.src : a.dst < b.dst;
+    };
+    for (double window_size : {0.3, 1.0})
+    {
+        Args args = {1, "data/worldcup-10K.graph.bin", 2000, {}, Args::SORT_MODE::SNAPSHOT, window_size, 1};
+        EdgeListDataset dataset(args);
+        SnapshotBuilder builder;
+        // Skip some batches, like when algorithms only run every few batches
+        for (int64_t batch_id : {0, 1, 2, 5, 9, 10, 21, 3})
+        {
+            auto expected = get_preprocessed_batch(batch_id, dataset, Args::SORT_MODE::SNAPSHOT);
+            auto actual = builder.update(batch_id, dataset);
+            ASSERT_EQ(expected->size(), actual->size());
+
+            // Edges should be sorted by out-degree of the source, then the destination
+            std::map<int64_t, int64_t> degrees;
+            for (const Edge& e : *actual) { degrees[e.src] += 1; }
+            for (size_t i = 1; i < actual->size(); ++i) {
+                const Edge& a = (*actual)[i-1];
+                const Edge& b = (*actual)[i];
+                ASSERT_GE(degrees[a.src], degrees[b.src]);
+                if (degrees[a.src] == degrees[b.src]) { ASSERT_GE(degrees[a.dst], degrees[b.dst]); }
+            }
+
+            // Compare the edges in a canonical order
+            std::vector<Edge> expected_edges(expected->begin(), expected->end());
+            std::vector<Edge> actual_edges(actual->begin(), actual->end());
+            std::sort(expected_edges.begin(), expected_edges.end(), by_pair);
+            std::sort(actual_edges.begin(), actual_edges.end(), by_pair);
+            EXPECT_EQ(expected_edges, actual_edges) << "Snapshot for batch " << batch_id << " differs";
+        }
+    }
+}
+
 INSTANTIATE_TEST_CASE_P(SortModeDoesntAffectEdgeCount, SortModeTest, ::testing::ValuesIn(SortModeTest::all_args));
 
 int main(int argc, char **argv)
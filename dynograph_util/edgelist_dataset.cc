@@ -3,26 +3,96 @@
 //
 
 #include "edgelist_dataset.h"
+#include "compressed_edges.h"
 #include "helpers.h"
 #include "logger.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <stddef.h>
 #include <algorithm>
+#include <vector>
 
 using namespace DynoGraph;
 using std::shared_ptr;
 using std::make_shared;
 
+// Returns the value of DYNOGRAPH_MMAP, or "" if unset
+static string
+get_mmap_mode()
+{
+    const char* value = getenv("DYNOGRAPH_MMAP");
+    return value ? string(value) : string("");
+}
+
+// Returns true if DYNOGRAPH_DATASET_META is set to a nonzero value
+static bool
+use_metadata()
+{
+    const char* value = getenv("DYNOGRAPH_DATASET_META");
+    return value && atoi(value) != 0;
+}
+
+namespace {
+
+// Contents of the sidecar file (input_path + ".meta") that records the result of validating a dataset
+// It is only written for valid datasets, so it implies the edges are sorted and have no self-edges
+struct dataset_metadata
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    // Size and modification time of the dataset, to detect when the metadata is stale
+    int64_t file_size;
+    int64_t file_mtime;
+    int64_t num_edges;
+    int64_t max_vertex_id;
+    int64_t min_timestamp;
+    int64_t max_timestamp;
+    // Checksum of all the preceding fields, to detect a corrupt metadata file
+    uint64_t checksum;
+};
+
+const char METADATA_MAGIC[8] = {'D', 'Y', 'N', 'O', 'M', 'E', 'T', 'A'};
+const uint32_t METADATA_VERSION = 1;
+
+// FNV-1a hash of the metadata fields before the checksum
+uint64_t
+metadata_checksum(const dataset_metadata& meta)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&meta);
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < offsetof(dataset_metadata, checksum); ++i)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // end anonymous namespace
+
 EdgeListDataset::EdgeListDataset(Args args)
-        : args(args), directed(true)
+        : args(args), directed(true), num_edges(0), mapping(NULL), mapping_size(0)
+        , block_offsets(NULL), edges_per_block(0)
 {
 
     Logger &logger = Logger::get_instance();
     // Load edges from the file
     if (has_suffix(args.input_path, ".graph.bin")) {
-        loadEdgesBinary(args.input_path);
+        string mmap_mode = get_mmap_mode();
+        if (mmap_mode.empty() || mmap_mode == "0") {
+            loadEdgesBinary(args.input_path);
+        } else {
+            mapEdgesBinary(args.input_path);
+        }
+    } else if (has_suffix(args.input_path, ".graph.cbin")) {
+        loadEdgesCompressed(args.input_path);
     } else if (has_suffix(args.input_path, ".graph.el")) {
         loadEdgesAscii(args.input_path);
     } else {
@@ -31,14 +101,14 @@ EdgeListDataset::EdgeListDataset(Args args)
     }
 
     // Intentionally rounding down to make it divide evenly
-    int64_t num_batches = edges.size() / args.batch_size;
+    num_batches = num_edges / args.batch_size;
 
     // Sanity check on arguments
-    if (static_cast<size_t>(args.batch_size) > edges.size())
+    if (args.batch_size > num_edges)
     {
         logger << "Invalid arguments: batch size (" << args.batch_size << ") "
                << "cannot be larger than the total number of edges in the dataset "
-               << " (" << edges.size() << ")\n";
+               << " (" << num_edges << ")\n";
         die();
     }
 
@@ -50,61 +120,250 @@ EdgeListDataset::EdgeListDataset(Args args)
         die();
     }
 
+    // Reuse the results of a previous validation if the file hasn't changed since then
+    if (!loadMetadata(args.input_path))
+    {
+        validateEdges();
+        if (use_metadata()) { saveMetadata(args.input_path); }
+    }
+
+    // Compressed batches are decoded on demand instead
+    if (isCompressed()) { return; }
+    for (int i = 0; i < num_batches; ++i)
+    {
+        size_t offset = i * args.batch_size;
+        auto begin = edges.begin() + offset;
+        auto end = edges.begin() + offset + args.batch_size;
+        batches.push_back(Batch(begin, end));
+    }
+}
+
+// Scans all edges once to calculate the max vertex ID and the timestamp range, and to make sure the dataset is valid
+// Each thread scans one block at a time, decompressing it if necessary
+void
+EdgeListDataset::validateEdges()
+{
+    Logger &logger = Logger::get_instance();
+    const int64_t block_size = isCompressed() ? edges_per_block : COMPRESSED_EDGES_PER_BLOCK;
+    const int64_t num_blocks = (num_edges + block_size - 1) / block_size;
+    std::vector<int64_t> first_timestamp(num_blocks);
+    std::vector<int64_t> last_timestamp(num_blocks);
+    int64_t max_id = 0;
+    bool sorted = true;
+    bool self_edge = false;
+    bool corrupt = false;
+    #pragma omp parallel reduction(max:max_id) reduction(&&:sorted) reduction(||:self_edge, corrupt)
+    {
+        pvector<Edge> buffer(isCompressed() ? block_size : 0);
+        #pragma omp for schedule(dynamic)
+        for (int64_t block = 0; block < num_blocks; ++block)
+        {
+            const int64_t begin = block * block_size;
+            const int64_t end = std::min(begin + block_size, num_edges);
+            const Edge* block_edges = isCompressed() ? buffer.begin() : &edges[begin];
+            if (isCompressed() && !decodeEdges(begin, end, buffer.begin())) {
+                corrupt = true;
+                continue;
+            }
+            for (int64_t i = 0; i < end - begin; ++i)
+            {
+                const Edge& e = block_edges[i];
+                max_id = std::max(max_id, std::max(e.src, e.dst));
+                sorted = sorted && (i == 0 || block_edges[i - 1].timestamp <= e.timestamp);
+                self_edge = self_edge || e.src == e.dst;
+            }
+            first_timestamp[block] = block_edges[0].timestamp;
+            last_timestamp[block] = block_edges[end - begin - 1].timestamp;
+        }
+    }
+    if (corrupt)
+    {
+        logger << "Corrupt compressed edge list in " << args.input_path << "\n";
+        die();
+    }
+
     // Calculate max vertex id so engines can statically provision the vertex array
-    max_vertex_id = Batch(edges).max_vertex_id();
+    max_vertex_id = max_id;
 
     // Make sure edges are sorted by timestamp, and save min/max timestamp
-    if (!std::is_sorted(edges.begin(), edges.end(),
-            [](const Edge& a, const Edge& b) { return a.timestamp < b.timestamp; }))
+    for (int64_t block = 1; block < num_blocks; ++block)
+    {
+        sorted = sorted && last_timestamp[block - 1] <= first_timestamp[block];
+    }
+    if (!sorted)
     {
         logger << "Invalid dataset: edges not sorted by timestamp\n";
         die();
     }
-
-    min_timestamp = edges.front().timestamp;
-    max_timestamp = edges.back().timestamp;
+    min_timestamp = first_timestamp.front();
+    max_timestamp = last_timestamp.back();
 
     // Make sure there are no self-edges
-    auto self_edge = std::find_if(edges.begin(), edges.end(),
-            [](const Edge& e) { return e.src == e.dst; });
-    if (self_edge != edges.end()) {
+    if (self_edge) {
         logger << "Invalid dataset: no self-edges allowed\n";
         die();
     }
+}
 
-    for (int i = 0; i < num_batches; ++i)
+// Loads the sidecar metadata for the dataset, if enabled
+// Returns false if the metadata is missing, corrupt, or out of date
+bool
+EdgeListDataset::loadMetadata(string path)
+{
+    if (!use_metadata()) { return false; }
+    Logger &logger = Logger::get_instance();
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) { return false; }
+
+    string meta_path = path + ".meta";
+    FILE* fp = fopen(meta_path.c_str(), "rb");
+    if (fp == NULL) { return false; }
+    dataset_metadata meta;
+    size_t rc = fread(&meta, sizeof(meta), 1, fp);
+    fclose(fp);
+    if (rc != 1
+     || memcmp(meta.magic, METADATA_MAGIC, sizeof(meta.magic)) != 0
+     || meta.version != METADATA_VERSION
+     || meta.checksum != metadata_checksum(meta))
     {
-        size_t offset = i * args.batch_size;
-        auto begin = edges.begin() + offset;
-        auto end = edges.begin() + offset + args.batch_size;
-        batches.push_back(Batch(begin, end));
+        logger << "Ignoring invalid metadata file " << meta_path << "\n";
+        return false;
+    }
+    if (meta.file_size != st.st_size
+     || meta.file_mtime != st.st_mtime
+     || meta.num_edges != num_edges)
+    {
+        logger << "Ignoring out-of-date metadata file " << meta_path << "\n";
+        return false;
     }
+
+    logger << "Loaded metadata from " << meta_path << ", skipping validation\n";
+    max_vertex_id = meta.max_vertex_id;
+    min_timestamp = meta.min_timestamp;
+    max_timestamp = meta.max_timestamp;
+    return true;
 }
 
-// Count the number of lines in a text file
-int64_t
-count_lines(string path)
+// Saves the results of validation next to the dataset, so the next run can skip it
+void
+EdgeListDataset::saveMetadata(string path)
 {
     Logger &logger = Logger::get_instance();
-    FILE* fp = fopen(path.c_str(), "r");
-    if (fp == NULL)
-    {
-        logger << "Failed to open " << path << "\n";
-        die();
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) { return; }
+
+    dataset_metadata meta;
+    memset(&meta, 0, sizeof(meta));
+    memcpy(meta.magic, METADATA_MAGIC, sizeof(meta.magic));
+    meta.version = METADATA_VERSION;
+    meta.file_size = st.st_size;
+    meta.file_mtime = st.st_mtime;
+    meta.num_edges = num_edges;
+    meta.max_vertex_id = max_vertex_id;
+    meta.min_timestamp = min_timestamp;
+    meta.max_timestamp = max_timestamp;
+    meta.checksum = metadata_checksum(meta);
+
+    // Failing to write the metadata is not fatal, the next run will just have to validate again
+    string meta_path = path + ".meta";
+    FILE* fp = fopen(meta_path.c_str(), "wb");
+    if (fp == NULL || fwrite(&meta, sizeof(meta), 1, fp) != 1) {
+        logger << "WARNING: failed to write metadata to " << meta_path << "\n";
+    } else {
+        logger << "Saved metadata to " << meta_path << "\n";
+    }
+    if (fp) { fclose(fp); }
+}
+
+namespace {
+
+// Each chunk of a text file is parsed independently, so a chunk should be big enough to amortize the thread overhead
+const size_t ASCII_CHUNK_SIZE = 16 << 20;
+
+// Edges parsed from one chunk of a text file
+struct parsed_chunk
+{
+    const char* begin;
+    const char* end;
+    std::vector<Edge> edges;
+    // Number of lines in the chunk, used to number the lines in later chunks
+    int64_t num_lines;
+    // Position and description of the first error in the chunk, if any
+    int64_t error_line;
+    const char* error;
+};
+
+inline bool
+is_blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Parses a signed decimal integer, leaving pos just past the last digit
+// Returns false if there is no integer at pos, or if it doesn't fit in an int64_t
+inline bool
+parse_int64(const char*& pos, const char* end, int64_t& value)
+{
+    while (pos < end && is_blank(*pos)) { ++pos; }
+    bool negative = false;
+    if (pos < end && *pos == '-') { negative = true; ++pos; }
+    const char* first_digit = pos;
+    // The magnitude of INT64_MIN is one more than INT64_MAX
+    const uint64_t limit = static_cast<uint64_t>(INT64_MAX) + (negative ? 1 : 0);
+    uint64_t x = 0;
+    for (; pos < end && *pos >= '0' && *pos <= '9'; ++pos) {
+        uint64_t digit = *pos - '0';
+        if (x > (limit - digit) / 10) { return false; }
+        x = x * 10 + digit;
     }
-    int64_t lines = 0;
-    while(!feof(fp))
+    if (pos == first_digit) { return false; }
+    value = negative ? static_cast<int64_t>(0 - x) : static_cast<int64_t>(x);
+    return true;
+}
+
+// Parses every line in the chunk, stopping at the first malformed line
+void
+parse_chunk(parsed_chunk& chunk)
+{
+    // Assume lines are at least 16 bytes long to avoid most reallocations
+    chunk.edges.reserve((chunk.end - chunk.begin) / 16);
+    chunk.num_lines = 0;
+    chunk.error = NULL;
+    const char* pos = chunk.begin;
+    while (pos < chunk.end)
     {
-        int ch = fgetc(fp);
-        if(ch == '\n')
+        const char* eol = static_cast<const char*>(memchr(pos, '\n', chunk.end - pos));
+        if (eol == NULL) { eol = chunk.end; }
+        chunk.num_lines += 1;
+
+        // Skip blank lines
+        const char* p = pos;
+        while (p < eol && is_blank(*p)) { ++p; }
+        if (p < eol)
         {
-            lines++;
+            Edge e;
+            if (!parse_int64(p, eol, e.src)
+             || !parse_int64(p, eol, e.dst)
+             || !parse_int64(p, eol, e.weight)
+             || !parse_int64(p, eol, e.timestamp))
+            {
+                chunk.error = "expected four integers (src dst weight timestamp)";
+            } else {
+                while (p < eol && is_blank(*p)) { ++p; }
+                if (p < eol) { chunk.error = "unexpected characters after timestamp"; }
+            }
+            if (chunk.error) {
+                chunk.error_line = chunk.num_lines;
+                return;
+            }
+            chunk.edges.push_back(e);
         }
+        pos = eol + 1;
     }
-    fclose(fp);
-    return lines;
 }
 
+} // end anonymous namespace
+
 void
 EdgeListDataset::loadEdgesBinary(string path)
 {
@@ -124,9 +383,11 @@ EdgeListDataset::loadEdgesBinary(string path)
            << directedStr
            << " edges from " << path << "...\n";
 
-    edges.resize(numEdges);
+    edge_storage.resize(numEdges);
+    edges = Range<Edge>(edge_storage);
+    num_edges = numEdges;
 
-    size_t rc = fread(&edges[0], sizeof(Edge), numEdges, fp);
+    size_t rc = fread(&edge_storage[0], sizeof(Edge), numEdges, fp);
     if (rc != static_cast<size_t>(numEdges))
     {
         logger << "Failed to load graph from " << path << "\n";
@@ -135,27 +396,272 @@ EdgeListDataset::loadEdgesBinary(string path)
     fclose(fp);
 }
 
+// Maps the file into memory instead of reading it, so batches point straight into the page cache
+// DYNOGRAPH_MMAP selects an access pattern hint for the kernel:
+//     sequential (read ahead aggressively), hugepage (back the mapping with huge pages), or 1 (no hint)
+void
+EdgeListDataset::mapEdgesBinary(string path)
+{
+    Logger &logger = Logger::get_instance();
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        logger << "Failed to open " << path << "\n";
+        die();
+    }
+    int64_t numEdges = st.st_size / sizeof(Edge);
+    if (numEdges == 0)
+    {
+        logger << "Failed to load graph from " << path << "\n";
+        die();
+    }
+
+    string directedStr = directed ? "directed" : "undirected";
+    logger << "Mapping " << numEdges << " "
+           << directedStr
+           << " edges from " << path << "...\n";
+
+    // Private mapping, so accidental writes to a batch never reach the file
+    mapping_size = numEdges * sizeof(Edge);
+    mapping = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        logger << "Failed to map " << path << ": " << strerror(errno) << "\n";
+        die();
+    }
+
+    string mode = get_mmap_mode();
+    int advice = -1;
+    if (mode == "sequential") {
+        advice = MADV_SEQUENTIAL;
+    } else if (mode == "hugepage") {
+#ifdef MADV_HUGEPAGE
+        advice = MADV_HUGEPAGE;
+#else
+        logger << "WARNING: huge pages not supported on this platform\n";
+#endif
+    }
+    // The hint is only an optimization, so failure is not fatal
+    if (advice != -1 && madvise(mapping, mapping_size, advice) != 0) {
+        logger << "WARNING: madvise failed for " << path << ": " << strerror(errno) << "\n";
+    }
+
+    Edge* begin = static_cast<Edge*>(mapping);
+    edges = Range<Edge>(begin, begin + numEdges);
+    num_edges = numEdges;
+}
+
+EdgeListDataset::~EdgeListDataset()
+{
+    if (mapping) { munmap(mapping, mapping_size); }
+}
+
+// Maps a compressed edge list into memory and checks the block index
+// The edges are not decoded until a batch is requested
+void
+EdgeListDataset::loadEdgesCompressed(string path)
+{
+    Logger &logger = Logger::get_instance();
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        logger << "Failed to open " << path << "\n";
+        die();
+    }
+    if (st.st_size == 0)
+    {
+        logger << "Failed to load graph from " << path << "\n";
+        die();
+    }
+    mapping_size = st.st_size;
+    mapping = mmap(NULL, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        logger << "Failed to map " << path << ": " << strerror(errno) << "\n";
+        die();
+    }
+
+    compressed_footer footer;
+    if (!read_compressed_index(static_cast<const uint8_t*>(mapping), mapping_size, footer, block_offsets))
+    {
+        logger << "Invalid compressed edge list index in " << path << "\n";
+        die();
+    }
+    num_edges = footer.num_edges;
+    edges_per_block = footer.edges_per_block;
+
+    string directedStr = directed ? "directed" : "undirected";
+    logger << "Mapping " << num_edges << " "
+           << directedStr
+           << " compressed edges from " << path << "...\n";
+}
+
+// Decodes edges [first, last) of a compressed dataset into out, one block per thread
+// Returns false if any of the blocks are corrupt
+bool
+EdgeListDataset::decodeEdges(int64_t first, int64_t last, Edge* out) const
+{
+    if (first >= last) { return true; }
+    const uint8_t* data = static_cast<const uint8_t*>(mapping);
+    const int64_t first_block = first / edges_per_block;
+    const int64_t last_block = (last - 1) / edges_per_block;
+    bool corrupt = false;
+    #pragma omp parallel for schedule(dynamic) reduction(||:corrupt)
+    for (int64_t block = first_block; block <= last_block; ++block)
+    {
+        const int64_t block_begin = block * edges_per_block;
+        const int64_t block_end = std::min(block_begin + edges_per_block, num_edges);
+        const int64_t begin = std::max(first, block_begin);
+        const int64_t end = std::min(last, block_end);
+        const uint8_t* encoded_begin = data + block_offsets[block];
+        const uint8_t* encoded_end = data + block_offsets[block + 1];
+        if (begin == block_begin && end == block_end) {
+            // The whole block is needed, decode it in place
+            corrupt = corrupt || !decode_edge_block(encoded_begin, encoded_end, block_end - block_begin, out + (begin - first));
+        } else {
+            // Blocks can only be decoded from the start, so decode all of it and keep the part in range
+            std::vector<Edge> buffer(block_end - block_begin);
+            if (decode_edge_block(encoded_begin, encoded_end, buffer.size(), buffer.data())) {
+                std::copy(buffer.begin() + (begin - block_begin), buffer.begin() + (end - block_begin), out + (begin - first));
+            } else {
+                corrupt = true;
+            }
+        }
+    }
+    return !corrupt;
+}
+
+namespace {
+
+// Batch that owns the edges decoded from a compressed dataset
+class DecodedBatch : public ConcreteBatch
+{
+public:
+    explicit DecodedBatch(size_t n) : ConcreteBatch(n)
+    {
+        begin_iter = edges.begin();
+        end_iter = edges.end();
+    }
+};
+
+} // end anonymous namespace
+
+// Returns a batch containing edges [first, last) of a compressed dataset
+shared_ptr<Batch>
+EdgeListDataset::decodeBatch(int64_t first, int64_t last) const
+{
+    shared_ptr<Batch> batch = make_shared<DecodedBatch>(last - first);
+    if (!decodeEdges(first, last, batch->begin()))
+    {
+        Logger::get_instance() << "Corrupt compressed edge list in " << args.input_path << "\n";
+        die();
+    }
+    return batch;
+}
+
+Edge
+EdgeListDataset::getEdge(int64_t i) const
+{
+    if (!isCompressed()) { return edges[i]; }
+    Edge e;
+    if (!decodeEdges(i, i + 1, &e))
+    {
+        Logger::get_instance() << "Corrupt compressed edge list in " << args.input_path << "\n";
+        die();
+    }
+    return e;
+}
+
+// Parses the text file in parallel: the file is mapped into memory and divided into chunks at line boundaries.
+// Each chunk is parsed into its own list of edges in a single pass, then the lists are concatenated.
 void
 EdgeListDataset::loadEdgesAscii(string path)
 {
     Logger &logger = Logger::get_instance();
-    logger << "Counting lines in " << path << "...\n";
-    int64_t numEdges = count_lines(path);
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        logger << "Failed to open " << path << "\n";
+        die();
+    }
+    const size_t file_size = st.st_size;
+    if (file_size == 0)
+    {
+        logger << "Failed to load graph from " << path << "\n";
+        die();
+    }
+    void* text = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (text == MAP_FAILED)
+    {
+        logger << "Failed to map " << path << ": " << strerror(errno) << "\n";
+        die();
+    }
+    madvise(text, file_size, MADV_SEQUENTIAL);
+
+    // Each chunk ends just after the first newline past its nominal end
+    const char* file_begin = static_cast<const char*>(text);
+    const char* file_end = file_begin + file_size;
+    const int64_t num_chunks = (file_size + ASCII_CHUNK_SIZE - 1) / ASCII_CHUNK_SIZE;
+    std::vector<parsed_chunk> chunks(num_chunks);
+    const char* chunk_begin = file_begin;
+    for (int64_t i = 0; i < num_chunks; ++i)
+    {
+        const char* chunk_end = file_end;
+        if (i + 1 < num_chunks)
+        {
+            const char* nominal_end = std::max(chunk_begin, file_begin + (i + 1) * ASCII_CHUNK_SIZE - 1);
+            const char* eol = static_cast<const char*>(memchr(nominal_end, '\n', file_end - nominal_end));
+            if (eol != NULL) { chunk_end = eol + 1; }
+        }
+        chunks[i].begin = chunk_begin;
+        chunks[i].end = chunk_end;
+        chunk_begin = chunk_end;
+    }
+
+    logger << "Parsing " << path << " in " << num_chunks << " chunks...\n";
+    #pragma omp parallel for schedule(dynamic)
+    for (int64_t i = 0; i < num_chunks; ++i)
+    {
+        parse_chunk(chunks[i]);
+    }
 
+    // Report the first error in the file, counting lines from the start of the file
+    int64_t first_line = 1;
+    std::vector<int64_t> offsets(num_chunks + 1, 0);
+    for (int64_t i = 0; i < num_chunks; ++i)
+    {
+        if (chunks[i].error)
+        {
+            logger << "Parse error in " << path << " at line " << first_line + chunks[i].error_line - 1
+                   << ": " << chunks[i].error << "\n";
+            die();
+        }
+        first_line += chunks[i].num_lines;
+        offsets[i + 1] = offsets[i] + chunks[i].edges.size();
+    }
+    munmap(text, file_size);
+
+    int64_t numEdges = offsets.back();
     string directedStr = directed ? "directed" : "undirected";
     logger << "Preloading " << numEdges << " "
            << directedStr
            << " edges from " << path << "...\n";
 
-    edges.resize(numEdges);
-
-    FILE* fp = fopen(path.c_str(), "r");
-    int rc = 0;
-    for (Edge* e = &edges[0]; rc != EOF; ++e)
+    edge_storage.resize(numEdges);
+    edges = Range<Edge>(edge_storage);
+    num_edges = numEdges;
+    #pragma omp parallel for schedule(dynamic)
+    for (int64_t i = 0; i < num_chunks; ++i)
     {
-        rc = fscanf(fp, "%ld %ld %ld %ld\n", &e->src, &e->dst, &e->weight, &e->timestamp);
+        std::copy(chunks[i].edges.begin(), chunks[i].edges.end(), edge_storage.begin() + offsets[i]);
+        std::vector<Edge>().swap(chunks[i].edges);
     }
-    fclose(fp);
 }
 
 int64_t
@@ -166,7 +672,7 @@ EdgeListDataset::getTimestampForWindow(int64_t batchId) const
     // Calculate width of timestamp window
     int64_t window_time = round_down(args.window_size * (max_timestamp - min_timestamp));
     // Get the timestamp of the last edge in the current batch
-    int64_t latest_time = (batches[batchId].end()-1)->timestamp;
+    int64_t latest_time = getEdge((batchId + 1) * args.batch_size - 1).timestamp;
 
     timestamp = std::max(min_timestamp, latest_time - window_time);
 
@@ -176,12 +682,14 @@ EdgeListDataset::getTimestampForWindow(int64_t batchId) const
 shared_ptr<Batch>
 EdgeListDataset::getBatch(int64_t batchId)
 {
+    if (isCompressed()) { return decodeBatch(batchId * args.batch_size, (batchId + 1) * args.batch_size); }
     return make_shared<Batch>(batches[batchId]);
 }
 
 shared_ptr<Batch>
 EdgeListDataset::getBatchesUpTo(int64_t batchId)
 {
+    if (isCompressed()) { return decodeBatch(0, (batchId + 1) * args.batch_size); }
     return make_shared<Batch>(&*edges.begin(), batches[batchId].end());
 }
 
@@ -199,12 +707,12 @@ EdgeListDataset::getMaxVertexId() const
 
 int64_t
 EdgeListDataset::getNumBatches() const {
-    return static_cast<int64_t>(batches.size());
+    return num_batches;
 };
 
 int64_t
 EdgeListDataset::getNumEdges() const {
-    return static_cast<int64_t>(edges.size());
+    return num_edges;
 }
 
 int64_t
@@ -11,19 +11,43 @@ class EdgeListDataset : public IDataset
 {
 private:
     void loadEdgesBinary(std::string path);
+    void mapEdgesBinary(std::string path);
+    void loadEdgesCompressed(std::string path);
     void loadEdgesAscii(std::string path);
+    bool isCompressed() const { return block_offsets != NULL; }
+    bool decodeEdges(int64_t first, int64_t last, Edge* out) const;
+    std::shared_ptr<Batch> decodeBatch(int64_t first, int64_t last) const;
+    Edge getEdge(int64_t i) const;
+    void validateEdges();
+    bool loadMetadata(std::string path);
+    void saveMetadata(std::string path);
 
     Args args;
     bool directed;
     int64_t max_vertex_id;
     int64_t min_timestamp;
     int64_t max_timestamp;
+    int64_t num_edges;
+    int64_t num_batches;
 
-    pvector<Edge> edges;
+    // Points to either edge_storage or the memory-mapped file
+    Range<Edge> edges;
+    pvector<Edge> edge_storage;
+    void* mapping;
+    size_t mapping_size;
     pvector<Batch> batches;
 
+    // Compressed datasets stay compressed in the memory mapping, and each batch is decoded when it is requested
+    // Points into the mapping at the block index, or NULL for uncompressed datasets
+    const uint64_t* block_offsets;
+    int64_t edges_per_block;
+
 public:
     EdgeListDataset(Args args);
+    ~EdgeListDataset();
+    // Batches may point into a memory mapping, which can't be shared between copies
+    EdgeListDataset(const EdgeListDataset&) = delete;
+    EdgeListDataset& operator=(const EdgeListDataset&) = delete;
 
     int64_t getTimestampForWindow(int64_t batchId) const;
     std::shared_ptr<Batch> getBatch(int64_t batchId);
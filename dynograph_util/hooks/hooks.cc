@@ -349,6 +349,7 @@ void Hooks::set_stat(std::string key, uint64_t value)       { pimpl->set_stat(ke
 void Hooks::set_stat(std::string key, int64_t value)        { pimpl->set_stat(key, value); }
 void Hooks::set_stat(std::string key, double value)         { pimpl->set_stat(key, value); }
 void Hooks::set_stat(std::string key, std::string value)    { pimpl->set_stat(key, value); }
+void Hooks::set_stat(std::string key, std::vector<double> value) { pimpl->set_stat(key, value); }
 
 // Implementation of C interface
 //
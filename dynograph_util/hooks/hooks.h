@@ -2,6 +2,7 @@
 
 #include <string>
 #include <cstdint>
+#include <vector>
 
 class Hooks
 {
@@ -22,6 +23,7 @@ public:
     void set_stat(std::string key, int64_t value);
     void set_stat(std::string key, double value);
     void set_stat(std::string key, std::string value);
+    void set_stat(std::string key, std::vector<double> value);
 private:
     Hooks();
     ~Hooks();
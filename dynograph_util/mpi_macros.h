@@ -8,6 +8,7 @@
 #ifdef USE_MPI
 #include <boost/mpi.hpp>
 #include <boost/mpi/collectives.hpp>
+#include <boost/serialization/vector.hpp>
 
 #define MPI_RANK_0_ONLY \
 if (::boost::mpi::communicator().rank() == 0)
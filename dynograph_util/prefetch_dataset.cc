@@ -0,0 +1,163 @@
+#include "prefetch_dataset.h"
+
+using namespace DynoGraph;
+using std::shared_ptr;
+
+namespace {
+
+// Read one edge from each page of the batch, so a memory-mapped dataset is faulted in ahead of time
+void
+touch_pages(const Batch& batch)
+{
+    const int64_t edges_per_page = 4096 / sizeof(Edge);
+    int64_t sum = 0;
+    for (const Edge* e = batch.begin(); e < batch.end(); e += edges_per_page) {
+        sum += e->src;
+    }
+    // Keep the compiler from removing the loop
+    volatile int64_t sink = sum;
+    (void)sink;
+}
+
+} // end anonymous namespace
+
+PrefetchDataset::PrefetchDataset(shared_ptr<IDataset> dataset, int64_t depth)
+: impl(dataset), depth(depth), next_batch_id(0), stop_requested(false) {}
+
+PrefetchDataset::~PrefetchDataset()
+{
+    stop();
+}
+
+void
+PrefetchDataset::prefetch_loop()
+{
+    const int64_t num_batches = impl->getNumBatches();
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        // Wait for room in the queue
+        queue_changed.wait(lock, [&]{
+            return stop_requested
+                || (static_cast<int64_t>(queue.size()) < depth && next_batch_id < num_batches);
+        });
+        if (stop_requested) { return; }
+
+        // Load the batch without holding the lock, so the consumer can take batches that are already loaded
+        int64_t batchId = next_batch_id;
+        lock.unlock();
+        shared_ptr<Batch> batch = impl->getBatch(batchId);
+        touch_pages(*batch);
+        lock.lock();
+
+        if (stop_requested) { return; }
+        queue.push_back(batch);
+        next_batch_id = batchId + 1;
+        queue_changed.notify_all();
+    }
+}
+
+void
+PrefetchDataset::start(int64_t batchId)
+{
+    next_batch_id = batchId;
+    stop_requested = false;
+    helper = std::thread(&PrefetchDataset::prefetch_loop, this);
+}
+
+void
+PrefetchDataset::stop()
+{
+    if (helper.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop_requested = true;
+        }
+        queue_changed.notify_all();
+        helper.join();
+    }
+    queue.clear();
+}
+
+shared_ptr<Batch>
+PrefetchDataset::getBatch(int64_t batchId)
+{
+    if (batchId < 0 || batchId >= impl->getNumBatches())
+    {
+        stop();
+        return impl->getBatch(batchId);
+    }
+
+    // Restart the helper thread if this isn't the batch it is working on
+    bool in_order;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        in_order = helper.joinable()
+                && batchId == next_batch_id - static_cast<int64_t>(queue.size());
+    }
+    if (!in_order)
+    {
+        stop();
+        start(batchId);
+    }
+
+    // Wait for the batch to be loaded
+    std::unique_lock<std::mutex> lock(mutex);
+    queue_changed.wait(lock, [&]{ return !queue.empty(); });
+    shared_ptr<Batch> batch = queue.front();
+    queue.pop_front();
+    queue_changed.notify_all();
+    return batch;
+}
+
+shared_ptr<Batch>
+PrefetchDataset::getBatchesUpTo(int64_t batchId)
+{
+    stop();
+    return impl->getBatchesUpTo(batchId);
+}
+
+int64_t
+PrefetchDataset::getTimestampForWindow(int64_t batchId) const
+{
+    return impl->getTimestampForWindow(batchId);
+}
+
+bool
+PrefetchDataset::isDirected() const
+{
+    return impl->isDirected();
+}
+
+int64_t
+PrefetchDataset::getMaxVertexId() const
+{
+    return impl->getMaxVertexId();
+}
+
+int64_t
+PrefetchDataset::getNumBatches() const {
+    return impl->getNumBatches();
+}
+
+int64_t
+PrefetchDataset::getNumEdges() const {
+    return impl->getNumEdges();
+}
+
+int64_t
+PrefetchDataset::getMinTimestamp() const {
+    return impl->getMinTimestamp();
+}
+
+int64_t
+PrefetchDataset::getMaxTimestamp() const {
+    return impl->getMaxTimestamp();
+}
+
+void
+PrefetchDataset::reset() {
+    stop();
+    impl->reset();
+}
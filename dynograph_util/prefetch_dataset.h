@@ -0,0 +1,48 @@
+#pragma once
+
+#include "idataset.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace DynoGraph {
+
+// Wraps another dataset, loading the next few batches on a helper thread while the current one is in use
+// Batches are prefetched in order, starting after the last batch requested with getBatch.
+// Any other access to the wrapped dataset (getBatchesUpTo, reset, out-of-order getBatch)
+// stops the helper thread first, so the wrapped dataset never needs to be thread-safe.
+class PrefetchDataset : public IDataset {
+private:
+    std::shared_ptr<IDataset> impl;
+    // Maximum number of batches to load ahead
+    int64_t depth;
+    // ID of the next batch the helper thread will load
+    int64_t next_batch_id;
+    // Batches that have been loaded, in order, starting with ID next_batch_id - queue.size()
+    std::deque<std::shared_ptr<Batch>> queue;
+    std::thread helper;
+    bool stop_requested;
+    std::mutex mutex;
+    std::condition_variable queue_changed;
+
+    void prefetch_loop();
+    void start(int64_t batchId);
+    void stop();
+public:
+    PrefetchDataset(std::shared_ptr<IDataset> dataset, int64_t depth);
+    ~PrefetchDataset();
+    int64_t getTimestampForWindow(int64_t batchId) const;
+    std::shared_ptr<Batch> getBatch(int64_t batchId);
+    std::shared_ptr<Batch> getBatchesUpTo(int64_t batchId);
+    int64_t getNumBatches() const;
+    int64_t getNumEdges() const;
+    bool isDirected() const;
+    int64_t getMaxVertexId() const;
+    int64_t getMinTimestamp() const;
+    int64_t getMaxTimestamp() const;
+    void reset();
+};
+
+}
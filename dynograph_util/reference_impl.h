@@ -105,7 +105,8 @@ public:
         );
         // Sort in order of increasing degree
         std::sort(degrees.begin(), degrees.end());
-        // Chop off the top n
+        // Chop off the top n (or fewer, if there aren't enough vertices)
+        n = std::min(n, static_cast<int64_t>(degrees.size()));
         degrees.erase(degrees.begin(), degrees.end() - n);
         // Return list of vertex ID's
         std::vector<int64_t> sources(n);
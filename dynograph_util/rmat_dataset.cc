@@ -53,20 +53,19 @@ RmatArgs::validate() const {
     return oss.str();
 }
 
-RmatDataset::RmatDataset(Args args, RmatArgs rmat_args)
+RmatDataset::RmatDataset(Args args, RmatArgs rmat_args, int rank, int num_ranks)
 : args(args)
 , rmat_args(rmat_args)
-, current_batch(0)
 , num_edges(rmat_args.num_edges)
 , num_batches(num_edges / args.batch_size)
 , num_vertices(rmat_args.num_vertices)
-, next_timestamp(0)
-, generator(rmat_args.num_vertices, rmat_args.a, rmat_args.b, rmat_args.c, rmat_args.d)
+, rank(rank)
+, num_ranks(num_ranks)
 {
     Logger &logger = Logger::get_instance();
 
     // Sanity check on arguments
-    if (static_cast<size_t>(args.batch_size) > num_edges)
+    if (args.batch_size > num_edges)
     {
         logger << "Invalid arguments: batch size (" << args.batch_size << ") "
                << "cannot be larger than the total number of edges in the dataset "
@@ -97,31 +96,28 @@ RmatDataset::getTimestampForWindow(int64_t batchId) const
     return timestamp;
 };
 
+int64_t
+RmatDataset::sliceBegin(int64_t n, int r) const
+{
+    return (r * n) / num_ranks;
+}
+
 std::shared_ptr<Batch>
 RmatDataset::getBatch(int64_t batchId)
 {
-    // Since this is a graph generator, batches must be generated in order
-    if (current_batch != batchId) {
-        reset();
-        generator.discard(batchId * args.batch_size);
-    }
-    current_batch = batchId + 1;
-
-    int64_t first_timestamp = next_timestamp;
-    next_timestamp += args.batch_size;
-    return std::make_shared<RmatBatch>(generator, args.batch_size, first_timestamp);
+    int64_t batch_begin = batchId * args.batch_size;
+    int64_t begin = batch_begin + sliceBegin(args.batch_size, rank);
+    int64_t end = batch_begin + sliceBegin(args.batch_size, rank + 1);
+    return std::make_shared<RmatBatch>(rmat_args, begin, end - begin);
 }
 
 std::shared_ptr<Batch>
 RmatDataset::getBatchesUpTo(int64_t batchId)
 {
-    // Since this is a graph generator, batches must be generated in order
-    reset();
-    current_batch = batchId + 1;
-
-    int64_t first_timestamp = next_timestamp;
-    next_timestamp += args.batch_size;
-    return std::make_shared<RmatBatch>(generator, current_batch * args.batch_size, first_timestamp);
+    int64_t n = (batchId + 1) * args.batch_size;
+    int64_t begin = sliceBegin(n, rank);
+    int64_t end = sliceBegin(n, rank + 1);
+    return std::make_shared<RmatBatch>(rmat_args, begin, end - begin);
 }
 
 bool
@@ -156,28 +152,35 @@ RmatDataset::getMaxTimestamp() const {
     return num_edges;
 }
 
-void
-RmatDataset::reset() {
-    current_batch = 0;
-    next_timestamp = 0;
-    generator = rmat_edge_generator(rmat_args.num_vertices, rmat_args.a, rmat_args.b, rmat_args.c, rmat_args.d);
-}
-
 // Implementation of RmatBatch
-RmatBatch::RmatBatch(rmat_edge_generator &generator, int64_t size, int64_t first_timestamp)
-: ConcreteBatch(size)
+
+// Self-edges are replaced by drawing from a separate stream of edges.
+// Each edge has its own range of this stream, so the replacement doesn't depend on any other edge.
+// Edges that need more re-rolls than this will borrow from the next edge's range, which is still deterministic.
+static const int64_t REROLLS_PER_EDGE = 16;
+static const uint32_t RMAT_SEED = 0;
+static const uint32_t REROLL_SEED = 1;
+
+// Generates edges [first_edge, first_edge + size) of the RMAT graph into edges
+static void
+generate_rmat_edges(const RmatArgs& rmat_args, int64_t first_edge, int64_t size, Edge* edges)
 {
-    // Make a local copy of the edge generator
-    rmat_edge_generator local_rng = generator;
+    // Make a local copy of the edge generator, positioned at the first edge
+    rmat_edge_generator local_rng(rmat_args.num_vertices, rmat_args.a, rmat_args.b, rmat_args.c, rmat_args.d, RMAT_SEED);
+    local_rng.discard(first_edge);
+    int64_t first_timestamp = first_edge;
+    // Self-edges are re-rolled from this stream, after skipping to the edge's own range
+    const rmat_edge_generator reroll_base(rmat_args.num_vertices, rmat_args.a, rmat_args.b, rmat_args.c, rmat_args.d, REROLL_SEED);
 
     // Keeps track of this thread's position in the random number stream relative to the loop index
     int64_t pos = 0;
 
     // Generate edges in parallel, while maintaining RNG state as if we did it serially
     // Mark the RNG with firstprivate so each thread gets a copy of the inital state
-    // Also mark the RNG with lastprivate so the master thread gets the state after the last iteration
+    // Since re-rolls don't use the main stream, self-edges can be replaced right away,
+    // and the result doesn't depend on the number of threads
     #pragma omp parallel for \
-    firstprivate(local_rng) lastprivate(local_rng) \
+    firstprivate(local_rng) \
     firstprivate(pos, first_timestamp) \
     schedule(static)
     for (int64_t i = 0; i < size; ++i)
@@ -196,23 +199,24 @@ RmatBatch::RmatBatch(rmat_edge_generator &generator, int64_t size, int64_t first
         e.weight = 1; // TODO random weights
         e.timestamp = first_timestamp++;
 
+        // Replace self-edges
+        if (e.src == e.dst) {
+            rmat_edge_generator reroll_rng = reroll_base;
+            reroll_rng.discard((first_edge + i) * REROLLS_PER_EDGE);
+            while (e.src == e.dst) {
+                reroll_rng.next_edge(&e.src, &e.dst);
+            }
+        }
+
         // Remember position, in case OpenMP jumps through the iteration space
         pos = i+1;
     }
+}
 
-    // Go back through the list and regenerate self-edges
-    // This step is serial, since we don't know how many times each edge has to be
-    // re-rolled before we get a non-self-edge
-    for (int64_t i = 0; i < size; ++i)
-    {
-        Edge& e = edges[i];
-        while (e.src == e.dst) {
-            local_rng.next_edge(&e.src, &e.dst);
-        }
-    }
-
-    // Copy final RNG state back to caller
-    generator = local_rng;
+RmatBatch::RmatBatch(const RmatArgs& rmat_args, int64_t first_edge, int64_t size)
+: ConcreteBatch(size)
+{
+    generate_rmat_edges(rmat_args, first_edge, size, &edges[0]);
 
     // Initialize batch pointers
     begin_iter = &*edges.begin();
@@ -16,24 +16,31 @@ struct RmatArgs
     std::string validate() const;
 };
 
+// Generates edges [first_edge, first_edge + size) of the RMAT graph described by rmat_args
+// Every edge is generated from a fixed position in the random stream, so any range can be generated
+// independently, and the edges don't depend on how the graph is divided up.
 class RmatBatch : public ConcreteBatch
 {
 public:
-    explicit RmatBatch(rmat_edge_generator& generator, int64_t size, int64_t first_timestamp);
+    explicit RmatBatch(const RmatArgs& rmat_args, int64_t first_edge, int64_t size);
 };
 
+// Generates batches of edges for an RMAT graph
+// When num_ranks > 1, each batch is divided into equal contiguous slices, and getBatch and getBatchesUpTo
+// return only this rank's slice. Every rank can then generate its own part of the graph without communication.
 class RmatDataset : public IDataset {
 private:
     Args args;
     RmatArgs rmat_args;
-    int64_t current_batch;
     int64_t num_edges;
     int64_t num_batches;
     int64_t num_vertices;
-    int64_t next_timestamp;
-    DynoGraph::rmat_edge_generator generator;
+    int rank;
+    int num_ranks;
+    // Index of the first edge in the first n edges of the graph that belongs to a rank's slice
+    int64_t sliceBegin(int64_t n, int r) const;
 public:
-    RmatDataset(Args args, RmatArgs rmat_args);
+    RmatDataset(Args args, RmatArgs rmat_args, int rank = 0, int num_ranks = 1);
 
     int64_t getTimestampForWindow(int64_t batchId) const;
     std::shared_ptr<Batch> getBatch(int64_t batchId);
@@ -45,8 +52,6 @@ public:
 
     bool isDirected() const;
     int64_t getMaxVertexId() const;
-
-    void reset();
 };
 
 } // end namespace DynoGraph
@@ -36,21 +36,11 @@ int main(int argc, const char* argv[])
         print_help_and_quit();
     }
 
-    // Create the rmat graph generator
-    rmat_edge_generator generator(
-        rmat_args.num_vertices,
-        rmat_args.a,
-        rmat_args.b,
-        rmat_args.c,
-        rmat_args.d,
-        0
-    );
-
     // Generate the edge list
     logger << "Generating RMAT graph with "
            << rmat_args.num_edges << " edges and "
            << rmat_args.num_vertices << " vertices.\n";
-    RmatBatch edge_list(generator, rmat_args.num_edges, 0);
+    RmatBatch edge_list(rmat_args, 0, rmat_args.num_edges);
 
     // Dump to file
     fwrite(edge_list.begin(), sizeof(Edge), edge_list.size(), fp);
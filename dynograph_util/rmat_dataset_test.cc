@@ -160,4 +160,51 @@ TEST(RmatDatasetTest, NoSelfEdges)
             EXPECT_NE(e.src, e.dst);
         }
     }
-}
\ No newline at end of file
+}
+
+// Make sure the batches are the same no matter how many ranks they are divided between
+TEST(RmatDatasetTest, SlicesMatchWholeBatches)
+{
+    Args args = {1, "dummy", 1000, {}, DynoGraph::Args::SORT_MODE::UNSORTED, 1.0, 1, 1};
+    RmatArgs rmat_args = RmatArgs::from_string("0.55-0.20-0.10-0.15-10K-1K.rmat");
+    RmatDataset whole(args, rmat_args);
+
+    auto check_slices = [](Batch& expected, std::vector<std::shared_ptr<Batch>>& slices) {
+        std::vector<Edge> actual;
+        for (auto& slice : slices) { actual.insert(actual.end(), slice->begin(), slice->end()); }
+        ASSERT_EQ(expected.size(), actual.size());
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), actual.begin()));
+    };
+
+    for (int num_ranks : {2, 3, 7}) {
+        std::vector<RmatDataset> ranks;
+        for (int rank = 0; rank < num_ranks; ++rank) {
+            ranks.emplace_back(args, rmat_args, rank, num_ranks);
+        }
+        for (int64_t batch_id = 0; batch_id < whole.getNumBatches(); ++batch_id)
+        {
+            std::vector<std::shared_ptr<Batch>> slices;
+            for (auto& rank : ranks) { slices.push_back(rank.getBatch(batch_id)); }
+            check_slices(*whole.getBatch(batch_id), slices);
+
+            slices.clear();
+            for (auto& rank : ranks) { slices.push_back(rank.getBatchesUpTo(batch_id)); }
+            check_slices(*whole.getBatchesUpTo(batch_id), slices);
+        }
+    }
+}
+
+// Make sure each edge is the same no matter which range of edges is generated with it,
+// so parallel generation doesn't depend on how the edges are divided between threads
+TEST(RmatDatasetTest, EdgesDontDependOnRange)
+{
+    // Use a small graph so there are plenty of self-edges to replace
+    RmatArgs rmat_args = RmatArgs::from_string("0.55-0.20-0.10-0.15-2K-16.rmat");
+    RmatBatch whole(rmat_args, 0, rmat_args.num_edges);
+    for (int64_t i = 0; i < rmat_args.num_edges; ++i)
+    {
+        RmatBatch single(rmat_args, i, 1);
+        ASSERT_EQ(whole.begin()[i], single.begin()[0]) << "Edge " << i << " differs";
+        EXPECT_NE(single.begin()[0].src, single.begin()[0].dst);
+    }
+}
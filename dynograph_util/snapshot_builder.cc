@@ -0,0 +1,117 @@
+#include "snapshot_builder.h"
+#include <algorithm>
+#include <vector>
+
+using namespace DynoGraph;
+using std::shared_ptr;
+using std::make_shared;
+
+namespace {
+
+// Batch that takes ownership of an edge list without copying it
+class OwningBatch : public Batch
+{
+private:
+    pvector<Edge> edges;
+public:
+    explicit OwningBatch(pvector<Edge>& storage)
+    {
+        edges.swap(storage);
+        begin_iter = edges.begin();
+        end_iter = edges.end();
+    }
+};
+
+// Stable counting sort of edges into out, by key(e) descending
+// Keys must be in the range [0, num_keys)
+template<typename Key>
+void
+counting_sort_descending(const pvector<Edge>& in, pvector<Edge>& out, int64_t num_keys, Key key)
+{
+    // The largest key goes in the first bucket
+    auto bucket = [&](const Edge& e) { return num_keys - 1 - key(e); };
+    std::vector<int64_t> offsets(num_keys + 1, 0);
+    for (const Edge& e : in) { offsets[bucket(e) + 1] += 1; }
+    for (int64_t i = 0; i < num_keys; ++i) { offsets[i + 1] += offsets[i]; }
+    for (const Edge& e : in) { out[offsets[bucket(e)]++] = e; }
+}
+
+} // end anonymous namespace
+
+SnapshotBuilder::SnapshotBuilder() : next_batch_id(0) {}
+
+void
+SnapshotBuilder::reset()
+{
+    pvector<Edge>().swap(edges);
+    next_batch_id = 0;
+}
+
+shared_ptr<Batch>
+SnapshotBuilder::update(int64_t batchId, IDataset &dataset)
+{
+    // Start over if asked for an earlier snapshot
+    if (batchId + 1 < next_batch_id) { reset(); }
+    int64_t threshold = dataset.getTimestampForWindow(batchId);
+
+    // Collect the edges in the window from the batches that aren't in the snapshot yet
+    pvector<Edge> new_edges;
+    for (; next_batch_id <= batchId; ++next_batch_id)
+    {
+        shared_ptr<Batch> batch = dataset.getBatch(next_batch_id);
+        for (const Edge& e : *batch) {
+            if (e.timestamp >= threshold) { new_edges.push_back(e); }
+        }
+    }
+
+    // Sort and deduplicate the new edges, keeping the most recent timestamp for each (src, dst) pair
+    std::sort(new_edges.begin(), new_edges.end(), [](const Edge& a, const Edge& b) {
+        return (a.src != b.src) ? a.src < b.src
+             : (a.dst != b.dst) ? a.dst < b.dst
+             :  a.timestamp > b.timestamp;
+    });
+    auto same_pair = [](const Edge& a, const Edge& b) { return a.src == b.src && a.dst == b.dst; };
+    Edge* new_end = std::unique(new_edges.begin(), new_edges.end(), same_pair);
+
+    // Merge the new edges into the snapshot, dropping edges that have fallen out of the window
+    pvector<Edge> merged(edges.size() + (new_end - new_edges.begin()));
+    Edge* out = merged.begin();
+    const Edge* a = edges.begin();
+    const Edge* b = new_edges.begin();
+    auto by_pair = [](const Edge& x, const Edge& y) {
+        return (x.src != y.src) ? x.src < y.src : x.dst < y.dst;
+    };
+    while (a != edges.end() || b != new_end)
+    {
+        if (a != edges.end() && a->timestamp < threshold) { ++a; continue; }
+        if (b == new_end || (a != edges.end() && by_pair(*a, *b))) {
+            *out++ = *a++;
+        } else if (a == edges.end() || by_pair(*b, *a)) {
+            *out++ = *b++;
+        } else {
+            // Same pair in both, keep the most recent
+            *out++ = a->timestamp > b->timestamp ? *a : *b;
+            ++a; ++b;
+        }
+    }
+    merged.resize(out - merged.begin());
+    edges.swap(merged);
+
+    // Count the out-degree of each vertex
+    int64_t max_vertex_id = 0;
+    for (const Edge& e : edges) { max_vertex_id = std::max(max_vertex_id, std::max(e.src, e.dst)); }
+    std::vector<int64_t> degrees(max_vertex_id + 1, 0);
+    int64_t max_degree = 0;
+    for (const Edge& e : edges) {
+        degrees[e.src] += 1;
+        max_degree = std::max(max_degree, degrees[e.src]);
+    }
+
+    // Order by out-degree of the source descending, then out-degree of the destination descending
+    // Two stable counting sorts do this in linear time (least significant key first)
+    pvector<Edge> by_dst(edges.size());
+    pvector<Edge> result(edges.size());
+    counting_sort_descending(edges, by_dst, max_degree + 1, [&](const Edge& e) { return degrees[e.dst]; });
+    counting_sort_descending(by_dst, result, max_degree + 1, [&](const Edge& e) { return degrees[e.src]; });
+    return make_shared<OwningBatch>(result);
+}
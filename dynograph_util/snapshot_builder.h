@@ -0,0 +1,30 @@
+#pragma once
+
+#include "batch.h"
+#include "idataset.h"
+#include "pvector.h"
+#include <memory>
+
+namespace DynoGraph {
+
+// Builds the cumulative, filtered, deduplicated snapshot of the graph for each epoch in snapshot mode
+// Instead of sorting every edge from the start of the stream each time, the builder keeps the previous
+// snapshot, sorts only the batches that were added since then, and merges them in.
+class SnapshotBuilder
+{
+private:
+    // Edges in the current snapshot, sorted by src then dst
+    // There is one edge for each (src, dst) pair, with the most recent timestamp
+    pvector<Edge> edges;
+    // ID of the first batch that hasn't been merged into the snapshot yet
+    int64_t next_batch_id;
+public:
+    SnapshotBuilder();
+    // Returns the snapshot of all edges up to and including batchId that are newer than the window threshold,
+    // in the same order as Batch::dedup_and_sort_by_out_degree
+    std::shared_ptr<Batch> update(int64_t batchId, IDataset &dataset);
+    // Forget the current snapshot, so the next update starts from the beginning of the dataset
+    void reset();
+};
+
+} // end namespace DynoGraph
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <cinttypes>
+
+/*
+ * Keeps a time-ordered list of segments, one for each batch of updates applied on this rank.
+ * Each segment remembers which local source vertices had out-edges inserted or updated,
+ * along with the range of timestamps in the batch.
+ *
+ * When deleting edges older than a threshold, only the sources listed in segments that
+ * start before the threshold need to be visited. Segments that lie entirely before the
+ * threshold are dropped in bulk, since every edge they refer to has either expired or been
+ * updated again (and recorded in a later segment).
+ */
+class edge_time_index
+{
+private:
+    struct segment
+    {
+        int64_t min_timestamp;
+        int64_t max_timestamp;
+        // Sorted list of source vertex ID's touched in this segment
+        std::vector<int64_t> sources;
+    };
+    std::deque<segment> segments;
+public:
+    // Records the sources touched by a batch, along with the range of timestamps in the batch
+    void
+    add_segment(std::vector<int64_t> sources, int64_t min_timestamp, int64_t max_timestamp)
+    {
+        if (sources.empty()) { return; }
+        segments.push_back({min_timestamp, max_timestamp, std::move(sources)});
+    }
+
+    // Returns the sorted, deduplicated list of sources that might hold edges older than threshold
+    // Segments that will be fully expired after deletion are removed from the index
+    std::vector<int64_t>
+    expire(int64_t threshold)
+    {
+        std::vector<int64_t> expired_sources;
+        for (auto seg = segments.begin(); seg != segments.end();)
+        {
+            if (seg->min_timestamp >= threshold) {
+                // Batches usually arrive in timestamp order, but keep scanning in case they don't
+                ++seg;
+                continue;
+            }
+            expired_sources.insert(expired_sources.end(), seg->sources.begin(), seg->sources.end());
+            if (seg->max_timestamp < threshold) {
+                seg = segments.erase(seg);
+            } else {
+                ++seg;
+            }
+        }
+        std::sort(expired_sources.begin(), expired_sources.end());
+        expired_sources.erase(
+            std::unique(expired_sources.begin(), expired_sources.end()),
+            expired_sources.end());
+        return expired_sources;
+    }
+
+    // Returns the number of segments in the index
+    size_t size() const { return segments.size(); }
+
+    void clear() { segments.clear(); }
+};
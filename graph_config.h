@@ -0,0 +1,55 @@
+#ifndef BOOST_DYNOGRAPH_GRAPH_CONFIG_H
+#define BOOST_DYNOGRAPH_GRAPH_CONFIG_H
+
+// The distributed graph is only available when building with MPI
+#if defined(USE_MPI)
+#include <boost/graph/use_mpi.hpp>
+#include <boost/graph/distributed/adjacency_list.hpp>
+#include <boost/graph/distributed/mpi_process_group.hpp>
+#endif
+#include <boost/graph/adjacency_list.hpp>
+typedef boost::vecS OutEdgeList;
+typedef boost::vecS VertexList;
+#define USE_EDGE_TIME_INDEX 1
+
+// Define a new edge property for timestamps
+namespace boost {
+    enum edge_timestamp_t { edge_timestamp };
+    BOOST_INSTALL_PROPERTY(edge, timestamp);
+}
+
+// Boost uses template nesting to implement multiple edge properties
+typedef boost::property< boost::edge_timestamp_t, int64_t> Timestamp;
+typedef boost::property< boost::edge_weight_t, int64_t, Timestamp> Weight;
+
+#if defined(USE_MPI)
+typedef boost::graph::distributed::mpi_process_group ProcessGroup;
+
+typedef boost::adjacency_list<
+    OutEdgeList,
+    boost::distributedS<ProcessGroup, VertexList>,
+    boost::bidirectionalS,
+    boost::no_property, /* Vertex properties */
+    Weight /* Edge properties */
+> Graph;
+
+// Integer type for referring to a vertex by ID number
+typedef boost::graph_traits<Graph>::vertices_size_type BoostVertexId;
+// Proxy object for a vertex that may be stored locally or remote
+typedef boost::graph_traits<Graph>::vertex_descriptor BoostVertex;
+typedef boost::graph_traits<Graph>::edge_descriptor BoostEdge;
+#endif
+
+// Graph type for the shared-memory implementation
+// Out-edges are only stored at the source vertex, so threads can modify different vertices concurrently
+typedef boost::adjacency_list<
+    OutEdgeList,
+    VertexList,
+    boost::directedS,
+    boost::no_property, /* Vertex properties */
+    Weight /* Edge properties */
+> SharedGraph;
+typedef boost::graph_traits<SharedGraph>::vertex_descriptor SharedVertex;
+typedef boost::graph_traits<SharedGraph>::edge_descriptor SharedEdge;
+
+#endif
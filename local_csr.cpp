@@ -0,0 +1,33 @@
+#include "local_csr.h"
+#include "boost_algs.h"
+#include <numeric>
+
+void
+local_csr::freeze(const Graph& g)
+{
+    auto comm = boost::mpi::communicator();
+    int64_t nv = static_cast<int64_t>(boost::num_vertices(g));
+    global_num_vertices = boost::mpi::all_reduce(comm, nv, std::plus<int64_t>());
+
+    // Count the degree of each local vertex, then prefix sum to get offsets
+    offsets.assign(nv + 1, 0);
+    BGL_FORALL_VERTICES_T(v, g, Graph)
+    {
+        offsets[v.local + 1] = boost::out_degree(v, g);
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    // Copy out the target and weight of each edge
+    targets.resize(offsets.back());
+    weights.resize(offsets.back());
+    BGL_FORALL_VERTICES_T(v, g, Graph)
+    {
+        int64_t pos = offsets[v.local];
+        BGL_FORALL_OUTEDGES_T(v, e, g, Graph)
+        {
+            targets[pos] = get_global_id(g, boost::target(e, g));
+            weights[pos] = get(boost::edge_weight, g, e);
+            ++pos;
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "graph_config.h"
+#include <vector>
+#include <cinttypes>
+
+/*
+ * Read-optimized snapshot of the edges stored on this rank, in compressed sparse row format
+ * Built from the distributed Graph with freeze() before running algorithms,
+ * and must be rebuilt after the graph is modified
+ */
+class local_csr
+{
+public:
+    // Number of vertices in the whole graph
+    int64_t global_num_vertices;
+    // Out-edges of local vertex i are stored in [offsets[i], offsets[i+1])
+    std::vector<int64_t> offsets;
+    // Global vertex ID of the target of each edge
+    std::vector<int64_t> targets;
+    // Weight of each edge
+    std::vector<int64_t> weights;
+
+    local_csr() : global_num_vertices(0) {}
+
+    // Copies the local edges of g into CSR format (collective)
+    void freeze(const Graph& g);
+
+    // Number of vertices stored on this rank
+    int64_t num_local_vertices() const { return static_cast<int64_t>(offsets.size()) - 1; }
+    // Number of edges stored on this rank
+    int64_t num_local_edges() const { return static_cast<int64_t>(targets.size()); }
+    // Out-degree of local vertex i
+    int64_t out_degree(int64_t i) const { return offsets[i+1] - offsets[i]; }
+};
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <boost/mpi.hpp>
+#include <vector>
+#include <numeric>
+#include <type_traits>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+// MPI counts and displacements are ints
+// Aborts every rank if a count is too large, rather than sending a truncated message
+inline int
+checked_count(const boost::mpi::communicator& comm, int64_t count)
+{
+    if (count > std::numeric_limits<int>::max()) {
+        std::cerr << "[DynoGraph] Rank " << comm.rank() << ": "
+                  << count << " values is too many for a single MPI exchange\n";
+        MPI_Abort(comm, 1);
+    }
+    return static_cast<int>(count);
+}
+
+// Narrows a list of per-rank counts to ints
+inline std::vector<int>
+checked_counts(const boost::mpi::communicator& comm, const std::vector<int64_t>& counts)
+{
+    std::vector<int> narrowed(counts.size());
+    for (size_t r = 0; r < counts.size(); ++r) { narrowed[r] = checked_count(comm, counts[r]); }
+    return narrowed;
+}
+
+// Returns the displacement of each rank's values, in values, for the given counts
+inline std::vector<int>
+displacements(const boost::mpi::communicator& comm, const std::vector<int>& counts)
+{
+    std::vector<int> displs(counts.size());
+    int64_t total = 0;
+    for (size_t r = 0; r < counts.size(); ++r) {
+        displs[r] = checked_count(comm, total);
+        total += counts[r];
+    }
+    return displs;
+}
+
+// MPI datatype for one value of type T, so that counts and displacements are in values rather than bytes
+template<typename T>
+MPI_Datatype
+value_datatype()
+{
+    static_assert(std::is_trivially_copyable<T>::value, "values are sent as raw bytes");
+    static MPI_Datatype datatype = [] {
+        MPI_Datatype t;
+        MPI_Type_contiguous(static_cast<int>(sizeof(T)), MPI_BYTE, &t);
+        MPI_Type_commit(&t);
+        return t;
+    }();
+    return datatype;
+}
+
+/*
+ * Personalized all-to-all exchange of plain-old-data values
+ * send_counts[r] values starting at send_buffer + (sum of send_counts before r) go to rank r
+ * Everything sent to this rank is stored in recv_buffer, in order of the sending rank
+ * Returns the number of values received from each rank
+ */
+template<typename T>
+std::vector<int>
+exchange(const boost::mpi::communicator& comm,
+    const T* send_buffer, const std::vector<int>& send_counts, std::vector<T>& recv_buffer)
+{
+    const int num_ranks = comm.size();
+
+    // Tell each rank how many values to expect
+    std::vector<int> recv_counts(num_ranks);
+    boost::mpi::all_to_all(comm, send_counts, recv_counts);
+    std::vector<int> send_displs = displacements(comm, send_counts);
+    std::vector<int> recv_displs = displacements(comm, recv_counts);
+
+    // Exchange the values themselves
+    recv_buffer.resize(std::accumulate(recv_counts.begin(), recv_counts.end(), static_cast<size_t>(0)));
+    MPI_Alltoallv(
+        send_buffer, send_counts.data(), send_displs.data(), value_datatype<T>(),
+        recv_buffer.data(), recv_counts.data(), recv_displs.data(), value_datatype<T>(),
+        comm);
+    return recv_counts;
+}
+
+// A rank can start the next sparse exchange before a slower rank has left this one,
+// so consecutive exchanges alternate between two tags to keep their messages apart
+inline int
+next_sparse_exchange_tag()
+{
+    static int round = 0;
+    return 1 + (round++ % 2);
+}
+
+/*
+ * Same as exchange(), but only talks to the ranks that actually have data to send or receive.
+ * Uses the nonblocking consensus algorithm (synchronous sends followed by a nonblocking barrier),
+ * so there is no all-to-all exchange of counts. Worthwhile when each rank only sends to a few others.
+ * Everything sent to this rank is stored in recv_buffer, in order of the sending rank
+ * Returns the number of values received from each rank
+ */
+template<typename T>
+std::vector<int>
+sparse_exchange(const boost::mpi::communicator& comm,
+    const T* send_buffer, const std::vector<int>& send_counts, std::vector<T>& recv_buffer)
+{
+    const int num_ranks = comm.size();
+    const int tag = next_sparse_exchange_tag();
+
+    // Post a synchronous send to each rank that gets at least one value
+    // A synchronous send completes only after the matching receive has started
+    std::vector<MPI_Request> send_requests;
+    const T* send_ptr = send_buffer;
+    for (int r = 0; r < num_ranks; ++r) {
+        if (send_counts[r] > 0) {
+            send_requests.emplace_back();
+            MPI_Issend(send_ptr, send_counts[r], value_datatype<T>(),
+                r, tag, comm, &send_requests.back());
+        }
+        send_ptr += send_counts[r];
+    }
+
+    // Receive messages until every rank has finished sending
+    std::vector<std::vector<T>> received(num_ranks);
+    MPI_Request barrier_request;
+    bool barrier_active = false;
+    for (;;)
+    {
+        int found;
+        MPI_Status status;
+        MPI_Iprobe(MPI_ANY_SOURCE, tag, comm, &found, &status);
+        if (found) {
+            int count;
+            MPI_Get_count(&status, value_datatype<T>(), &count);
+            std::vector<T>& values = received[status.MPI_SOURCE];
+            values.resize(count);
+            MPI_Recv(values.data(), count, value_datatype<T>(), status.MPI_SOURCE, tag, comm, MPI_STATUS_IGNORE);
+        }
+        if (barrier_active) {
+            // Once every rank has entered the barrier, no messages are left in flight
+            int done;
+            MPI_Test(&barrier_request, &done, MPI_STATUS_IGNORE);
+            if (done) { break; }
+        } else {
+            // All of our messages have been received, let the other ranks know
+            int done;
+            MPI_Testall(static_cast<int>(send_requests.size()), send_requests.data(), &done, MPI_STATUSES_IGNORE);
+            if (done) {
+                MPI_Ibarrier(comm, &barrier_request);
+                barrier_active = true;
+            }
+        }
+    }
+
+    // Concatenate in order of the sending rank
+    std::vector<int> recv_counts(num_ranks);
+    size_t total = 0;
+    for (int r = 0; r < num_ranks; ++r) {
+        recv_counts[r] = static_cast<int>(received[r].size());
+        total += received[r].size();
+    }
+    recv_buffer.clear();
+    recv_buffer.reserve(total);
+    for (const auto& values : received) {
+        recv_buffer.insert(recv_buffer.end(), values.begin(), values.end());
+    }
+    return recv_counts;
+}
+
+// Sends buckets[r] to rank r, returns everything sent to this rank
+template<typename T>
+std::vector<T>
+exchange(const boost::mpi::communicator& comm, const std::vector<std::vector<T>>& buckets)
+{
+    std::vector<int> send_counts(buckets.size());
+    std::vector<T> send_buffer;
+    size_t total = 0;
+    for (const auto& bucket : buckets) { total += bucket.size(); }
+    send_buffer.reserve(total);
+    for (size_t r = 0; r < buckets.size(); ++r) {
+        send_counts[r] = checked_count(comm, buckets[r].size());
+        send_buffer.insert(send_buffer.end(), buckets[r].begin(), buckets[r].end());
+    }
+    std::vector<T> recv_buffer;
+    exchange(comm, send_buffer.data(), send_counts, recv_buffer);
+    return recv_buffer;
+}
+
+/*
+ * Nonblocking version of exchange(), so the data can be in flight while the caller does other work
+ * post() sends the counts with a blocking all-to-all, then starts sending the values themselves
+ * wait() blocks until everything sent to this rank has arrived
+ * Keeps track of the time spent blocked in MPI, i.e. communication that was not hidden behind other work
+ */
+template<typename T>
+class pending_exchange
+{
+private:
+    std::vector<T> send_buffer;
+    std::vector<T> recv_buffer;
+    std::vector<int> send_counts, send_displs;
+    std::vector<int> recv_counts, recv_displs;
+    MPI_Request request;
+    double blocked_ms;
+
+    static double
+    elapsed_ms(std::chrono::steady_clock::time_point t1)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t1).count();
+    }
+public:
+    pending_exchange() : request(MPI_REQUEST_NULL), blocked_ms(0) {}
+    // Not copyable, since MPI holds pointers into the buffers
+    pending_exchange(const pending_exchange&) = delete;
+    pending_exchange& operator=(const pending_exchange&) = delete;
+
+    // Starts sending counts[r] values to rank r, taking ownership of the send buffer
+    void
+    post(const boost::mpi::communicator& comm, std::vector<T> values, const std::vector<int>& counts)
+    {
+        auto t1 = std::chrono::steady_clock::now();
+        const int num_ranks = comm.size();
+        send_buffer = std::move(values);
+
+        // Tell each rank how many values to expect
+        // MPI holds on to the counts and displacements until the exchange completes
+        send_counts = counts;
+        recv_counts.assign(num_ranks, 0);
+        boost::mpi::all_to_all(comm, send_counts, recv_counts);
+        send_displs = displacements(comm, send_counts);
+        recv_displs = displacements(comm, recv_counts);
+
+        // Start sending the values
+        recv_buffer.resize(std::accumulate(recv_counts.begin(), recv_counts.end(), static_cast<size_t>(0)));
+        MPI_Ialltoallv(
+            send_buffer.data(), send_counts.data(), send_displs.data(), value_datatype<T>(),
+            recv_buffer.data(), recv_counts.data(), recv_displs.data(), value_datatype<T>(),
+            comm, &request);
+        blocked_ms += elapsed_ms(t1);
+    }
+
+    // Waits for the exchange to complete, then returns everything sent to this rank, in order of the sending rank
+    std::vector<T>&
+    wait()
+    {
+        auto t1 = std::chrono::steady_clock::now();
+        MPI_Wait(&request, MPI_STATUS_IGNORE);
+        blocked_ms += elapsed_ms(t1);
+        send_buffer.clear();
+        return recv_buffer;
+    }
+
+    // Total time spent blocked in post() and wait()
+    double get_blocked_ms() const { return blocked_ms; }
+};
@@ -0,0 +1,325 @@
+#include "shared_algs.h"
+#include <dynograph_util/alg_data_manager.h>
+#include <dynograph_util/hooks/dynograph_edge_count.h>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <iostream>
+
+using std::string;
+using std::vector;
+using std::cerr;
+
+void runAlgorithm(string algName, SharedGraph &g, const vector<int64_t> &sources, DynoGraph::Range<int64_t> data)
+{
+    const int64_t nv = boost::num_vertices(g);
+    if (algName == "bfs") {
+        vector<uint64_t> mask = run_multi_source_bfs(g, sources);
+        #pragma omp parallel for
+        for (int64_t v = 0; v < nv; ++v) { data[v] = static_cast<int64_t>(mask[v]); }
+    } else if (algName == "cc") {
+        vector<int64_t> component = run_cc(g);
+        #pragma omp parallel for
+        for (int64_t v = 0; v < nv; ++v) { data[v] = component[v] + 1; }
+    } else if (algName == "gc") {
+        vector<int64_t> color = run_gc(g);
+        std::copy(color.begin(), color.end(), data.begin());
+    } else if (algName == "pagerank") {
+        vector<double> ranks = run_pagerank(g);
+        #pragma omp parallel for
+        for (int64_t v = 0; v < nv; ++v) {
+            data[v] = DynoGraph::to_fixed_point(ranks[v], DynoGraph::PAGERANK_FIXED_POINT_SCALE);
+        }
+    } else if (algName == "sssp") {
+        vector<int64_t> distance = run_sssp(g, sources[0]);
+        const int64_t infinity = std::numeric_limits<int64_t>::max();
+        #pragma omp parallel for
+        for (int64_t v = 0; v < nv; ++v) { data[v] = distance[v] == infinity ? -1 : distance[v]; }
+    } else {
+        cerr << "Algorithm " << algName << " not implemented!\n";
+        exit(-1);
+    }
+}
+
+// Atomically replaces *ptr with val if val is smaller, returns true if the value was replaced
+static bool
+atomic_min(int64_t *ptr, int64_t val)
+{
+    int64_t old_val = *ptr;
+    while (val < old_val) {
+        if (__sync_bool_compare_and_swap(ptr, old_val, val)) { return true; }
+        old_val = *ptr;
+    }
+    return false;
+}
+
+// Appends a thread-local list onto a shared list
+static void
+append(vector<int64_t> &shared, const vector<int64_t> &local)
+{
+    #pragma omp critical
+    shared.insert(shared.end(), local.begin(), local.end());
+}
+
+vector<int64_t> run_bfs(const SharedGraph &g, int64_t source)
+{
+    const int64_t nv = boost::num_vertices(g);
+    vector<int64_t> distance(nv, -1);
+    vector<int64_t> frontier = {source};
+    distance[source] = 0;
+
+    // Level-synchronous top-down traversal
+    for (int64_t level = 1; !frontier.empty(); ++level)
+    {
+        vector<int64_t> next_frontier;
+        #pragma omp parallel
+        {
+            vector<int64_t> local_frontier;
+            #pragma omp for schedule(dynamic, 64)
+            for (size_t i = 0; i < frontier.size(); ++i)
+            {
+                SharedVertex u = frontier[i];
+                BGL_FORALL_ADJ_T(u, v, g, SharedGraph)
+                {
+                    // Claim the vertex if nobody else has yet
+                    if (distance[v] == -1 && __sync_bool_compare_and_swap(&distance[v], -1, level)) {
+                        local_frontier.push_back(v);
+                    }
+                }
+            }
+            append(next_frontier, local_frontier);
+        }
+        frontier.swap(next_frontier);
+    }
+    return distance;
+}
+
+vector<uint64_t> run_multi_source_bfs(const SharedGraph &g, const vector<int64_t> &sources)
+{
+    const int64_t nv = boost::num_vertices(g);
+    const size_t num_sources = std::min<size_t>(sources.size(), 64);
+    // Sources that have reached each vertex, and the ones that reached it in the last level
+    vector<uint64_t> seen(nv, 0);
+    vector<uint64_t> current(nv, 0);
+    vector<uint64_t> next(nv, 0);
+    vector<int64_t> frontier;
+    for (size_t i = 0; i < num_sources; ++i)
+    {
+        int64_t s = sources[i];
+        if (current[s] == 0) { frontier.push_back(s); }
+        seen[s] |= 1ULL << i;
+        current[s] |= 1ULL << i;
+    }
+
+    // Level-synchronous traversal, each vertex passes on the sources that reached it in the last level
+    while (!frontier.empty())
+    {
+        vector<int64_t> next_frontier;
+        #pragma omp parallel
+        {
+            vector<int64_t> local_frontier;
+            #pragma omp for schedule(dynamic, 64)
+            for (size_t i = 0; i < frontier.size(); ++i)
+            {
+                SharedVertex u = frontier[i];
+                uint64_t bits = current[u];
+                BGL_FORALL_ADJ_T(u, v, g, SharedGraph)
+                {
+                    uint64_t new_bits = bits & ~__atomic_load_n(&seen[v], __ATOMIC_RELAXED);
+                    if (new_bits == 0) { continue; }
+                    new_bits &= ~__atomic_fetch_or(&seen[v], new_bits, __ATOMIC_RELAXED);
+                    // The first thread to give v any new sources puts it in the next frontier
+                    if (new_bits != 0 && __atomic_fetch_or(&next[v], new_bits, __ATOMIC_RELAXED) == 0) {
+                        local_frontier.push_back(v);
+                    }
+                }
+            }
+            append(next_frontier, local_frontier);
+        }
+        for (int64_t u : frontier) { current[u] = 0; }
+        current.swap(next);
+        frontier.swap(next_frontier);
+    }
+    return seen;
+}
+
+vector<int64_t> run_sssp(const SharedGraph &g, int64_t source)
+{
+    const int64_t nv = boost::num_vertices(g);
+    const int64_t infinity = std::numeric_limits<int64_t>::max();
+    vector<int64_t> distance(nv, infinity);
+    // Marks vertices that are already in the next frontier
+    vector<int64_t> in_frontier(nv, 0);
+    vector<int64_t> frontier = {source};
+    distance[source] = 0;
+
+    // Frontier-based Bellman-Ford: relax the out-edges of vertices whose distance changed
+    while (!frontier.empty())
+    {
+        vector<int64_t> next_frontier;
+        #pragma omp parallel
+        {
+            vector<int64_t> local_frontier;
+            #pragma omp for schedule(dynamic, 64)
+            for (size_t i = 0; i < frontier.size(); ++i)
+            {
+                SharedVertex u = frontier[i];
+                // Leave the frontier before reading the distance, with sequentially consistent atomics.
+                // A thread that lowers distance[u] after this read will see the flag cleared and add u again.
+                __atomic_store_n(&in_frontier[u], 0, __ATOMIC_SEQ_CST);
+                int64_t du = __atomic_load_n(&distance[u], __ATOMIC_SEQ_CST);
+                BGL_FORALL_OUTEDGES_T(u, e, g, SharedGraph)
+                {
+                    SharedVertex v = boost::target(e, g);
+                    int64_t dv = du + get(boost::edge_weight, g, e);
+                    if (atomic_min(&distance[v], dv)
+                     && __sync_bool_compare_and_swap(&in_frontier[v], 0, 1)) {
+                        local_frontier.push_back(v);
+                    }
+                }
+            }
+            append(next_frontier, local_frontier);
+        }
+        frontier.swap(next_frontier);
+    }
+    return distance;
+}
+
+vector<int64_t> run_cc(const SharedGraph &g)
+{
+    const int64_t nv = boost::num_vertices(g);
+    vector<int64_t> component(nv);
+    #pragma omp parallel for
+    for (int64_t v = 0; v < nv; ++v) { component[v] = v; }
+
+    // Label propagation, treating each edge as undirected
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        #pragma omp parallel for schedule(dynamic, 64) reduction(||:changed)
+        for (int64_t u = 0; u < nv; ++u)
+        {
+            BGL_FORALL_ADJ_T(u, v, g, SharedGraph)
+            {
+                int64_t cu = component[u];
+                int64_t cv = component[v];
+                if (cu < cv) { changed |= atomic_min(&component[v], cu); }
+                else if (cv < cu) { changed |= atomic_min(&component[u], cv); }
+            }
+        }
+    }
+    return component;
+}
+
+vector<int64_t> run_gc(const SharedGraph &g)
+{
+    const int64_t nv = boost::num_vertices(g);
+
+    // Coloring constraints go both ways, so build an undirected copy of the adjacency lists
+    vector<int64_t> offsets(nv + 1, 0);
+    BGL_FORALL_VERTICES_T(u, g, SharedGraph)
+    {
+        BGL_FORALL_ADJ_T(u, v, g, SharedGraph)
+        {
+            offsets[u + 1] += 1;
+            offsets[v + 1] += 1;
+        }
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    vector<int64_t> neighbors(offsets.back());
+    {
+        vector<int64_t> pos(offsets.begin(), offsets.end() - 1);
+        BGL_FORALL_VERTICES_T(u, g, SharedGraph)
+        {
+            BGL_FORALL_ADJ_T(u, v, g, SharedGraph)
+            {
+                neighbors[pos[u]++] = v;
+                neighbors[pos[v]++] = u;
+            }
+        }
+    }
+
+    // Speculative greedy coloring: color all vertices in parallel, then recolor
+    // the vertices that ended up with the same color as a lower-numbered neighbor
+    vector<int64_t> color(nv, -1);
+    vector<int64_t> worklist(nv);
+    #pragma omp parallel for
+    for (int64_t v = 0; v < nv; ++v) { worklist[v] = v; }
+    while (!worklist.empty())
+    {
+        #pragma omp parallel
+        {
+            vector<char> used;
+            #pragma omp for schedule(dynamic, 64)
+            for (size_t i = 0; i < worklist.size(); ++i)
+            {
+                int64_t u = worklist[i];
+                int64_t degree = offsets[u+1] - offsets[u];
+                // Pick the smallest color not used by a neighbor
+                used.assign(degree + 1, 0);
+                for (int64_t j = offsets[u]; j < offsets[u+1]; ++j)
+                {
+                    int64_t c = color[neighbors[j]];
+                    if (c >= 0 && c <= degree) { used[c] = 1; }
+                }
+                DYNOGRAPH_EDGE_COUNT_TRAVERSE_MULTIPLE_EDGES(degree);
+                color[u] = std::find(used.begin(), used.end(), 0) - used.begin();
+            }
+        }
+        vector<int64_t> conflicts;
+        #pragma omp parallel
+        {
+            vector<int64_t> local_conflicts;
+            #pragma omp for schedule(dynamic, 64)
+            for (size_t i = 0; i < worklist.size(); ++i)
+            {
+                int64_t u = worklist[i];
+                for (int64_t j = offsets[u]; j < offsets[u+1]; ++j)
+                {
+                    int64_t v = neighbors[j];
+                    if (v < u && color[v] == color[u]) {
+                        local_conflicts.push_back(u);
+                        break;
+                    }
+                }
+            }
+            append(conflicts, local_conflicts);
+        }
+        worklist.swap(conflicts);
+    }
+    return color;
+}
+
+vector<double> run_pagerank(const SharedGraph &g)
+{
+    const int64_t nv = boost::num_vertices(g);
+    const double damping = 0.85;
+    const int num_iterations = 20;
+
+    vector<double> ranks(nv, 1.0 / nv);
+    vector<double> sums(nv);
+    for (int iter = 0; iter < num_iterations; ++iter)
+    {
+        std::fill(sums.begin(), sums.end(), 0.0);
+        // Push the contribution of each vertex along its out-edges
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (int64_t u = 0; u < nv; ++u)
+        {
+            int64_t degree = boost::out_degree(u, g);
+            if (degree == 0) { continue; }
+            double contribution = ranks[u] / degree;
+            BGL_FORALL_ADJ_T(u, v, g, SharedGraph)
+            {
+                #pragma omp atomic
+                sums[v] += contribution;
+            }
+        }
+        #pragma omp parallel for
+        for (int64_t v = 0; v < nv; ++v)
+        {
+            ranks[v] = (1 - damping) / nv + damping * sums[v];
+        }
+    }
+    return ranks;
+}
@@ -0,0 +1,30 @@
+#ifndef BOOST_DYNOGRAPH_SHARED_ALGS_H
+#define BOOST_DYNOGRAPH_SHARED_ALGS_H
+
+// HACK This includes a modified version of the boost graph iteration macro header that counts edges
+#include "iteration_macros.hpp"
+
+#include "graph_config.h"
+#include <dynograph_util/range.h>
+#include <string>
+#include <vector>
+#include <inttypes.h>
+
+// OpenMP-parallel algorithms for the shared-memory implementation
+// Results are returned with one entry per vertex
+
+// Writes the results into data, in the same form as the distributed implementation:
+// bfs: mask of the sources that reach each vertex, cc: smallest vertex ID in the component plus one,
+// gc: color, pagerank: fixed-point rank, sssp: distance from the first source, -1 for unreached vertices
+void runAlgorithm(std::string algName, SharedGraph &g, const std::vector<int64_t> &sources,
+    DynoGraph::Range<int64_t> data);
+
+std::vector<int64_t> run_bfs(const SharedGraph &g, int64_t source);
+// Traverses from up to 64 sources at once, returns the mask of sources that reach each vertex
+std::vector<uint64_t> run_multi_source_bfs(const SharedGraph &g, const std::vector<int64_t> &sources);
+std::vector<int64_t> run_cc(const SharedGraph &g);
+std::vector<int64_t> run_gc(const SharedGraph &g);
+std::vector<int64_t> run_sssp(const SharedGraph &g, int64_t source);
+std::vector<double> run_pagerank(const SharedGraph &g);
+
+#endif //BOOST_DYNOGRAPH_SHARED_ALGS_H
@@ -0,0 +1,168 @@
+#include "shared_dynamic_graph.h"
+#include <algorithm>
+#include <tuple>
+
+using std::vector;
+using DynoGraph::Edge;
+
+shared_dynamic_graph::shared_dynamic_graph(DynoGraph::Args args, int64_t max_vertex_id)
+: DynoGraph::DynamicGraph(args, max_vertex_id)
+, g(static_cast<size_t>(max_vertex_id+1))
+, num_edges(0)
+, num_vertices(0)
+{}
+
+shared_dynamic_graph::shared_dynamic_graph(DynoGraph::Args args, int64_t max_vertex_id, const DynoGraph::Batch & batch)
+: shared_dynamic_graph(args, max_vertex_id)
+{
+    insert_batch(batch);
+}
+
+void
+shared_dynamic_graph::before_batch(const DynoGraph::Batch &batch, int64_t threshold) {
+
+}
+
+void
+shared_dynamic_graph::delete_edges_older_than(int64_t threshold)
+{
+    auto expired = [&](const SharedEdge &e)
+    {
+        return get(boost::edge_timestamp, g, e) < threshold;
+    };
+    const int64_t nv = boost::num_vertices(g);
+    int64_t edges_removed = 0;
+    int64_t vertices_removed = 0;
+    #pragma omp parallel for schedule(dynamic, 64) reduction(+:edges_removed, vertices_removed)
+    for (int64_t v = 0; v < nv; ++v)
+    {
+        int64_t old_degree = boost::out_degree(v, g);
+        if (old_degree == 0) { continue; }
+        boost::remove_out_edge_if(v, expired, g);
+        int64_t new_degree = boost::out_degree(v, g);
+        edges_removed += old_degree - new_degree;
+        if (new_degree == 0) { vertices_removed += 1; }
+    }
+    num_edges -= edges_removed;
+    num_vertices -= vertices_removed;
+}
+
+void
+shared_dynamic_graph::insert_batch(const DynoGraph::Batch &batch)
+{
+    // Sort the updates to group them by source vertex, then by destination
+    vector<Edge> updates(batch.begin(), batch.end());
+    std::sort(updates.begin(), updates.end(), [](const Edge& a, const Edge& b) {
+        return std::tie(a.src, a.dst) < std::tie(b.src, b.dst);
+    });
+
+    // Find where the updates for each source vertex begin
+    vector<size_t> group_begin;
+    for (size_t i = 0; i < updates.size(); ++i)
+    {
+        if (i == 0 || updates[i].src != updates[i-1].src) { group_begin.push_back(i); }
+    }
+    group_begin.push_back(updates.size());
+    const int64_t num_groups = static_cast<int64_t>(group_begin.size()) - 1;
+
+    // Each source vertex is updated by exactly one thread
+    int64_t edges_added = 0;
+    int64_t vertices_added = 0;
+    #pragma omp parallel for schedule(dynamic, 16) reduction(+:edges_added, vertices_added)
+    for (int64_t group = 0; group < num_groups; ++group)
+    {
+        auto first = updates.begin() + group_begin[group];
+        auto last = updates.begin() + group_begin[group + 1];
+        SharedVertex src = first->src;
+        int64_t old_degree = boost::out_degree(src, g);
+        auto dst_compare = [](const Edge& a, const Edge& b) { return a.dst < b.dst; };
+
+        // Update existing edges, remembering which updates were applied
+        vector<bool> done(last - first, false);
+        BGL_FORALL_OUTEDGES_T(src, e, g, SharedGraph)
+        {
+            Edge key;
+            key.dst = boost::target(e, g);
+            auto match = std::lower_bound(first, last, key, dst_compare);
+            if (match == last || match->dst != key.dst) { continue; }
+            auto weight = get(boost::edge_weight, g, e);
+            auto timestamp = get(boost::edge_timestamp, g, e);
+            for (; match < last && match->dst == key.dst; ++match)
+            {
+                weight += match->weight;
+                timestamp = std::max(timestamp, match->timestamp);
+                done[match - first] = true;
+            }
+            put(boost::edge_weight, g, e, weight);
+            put(boost::edge_timestamp, g, e, timestamp);
+        }
+
+        // Add any remaining updates as new edges, combining duplicates
+        for (auto u = first; u < last;)
+        {
+            if (done[u - first]) { ++u; continue; }
+            int64_t dst = u->dst;
+            int64_t weight = 0;
+            int64_t timestamp = 0;
+            for (; u < last && u->dst == dst; ++u)
+            {
+                weight += u->weight;
+                timestamp = std::max(timestamp, u->timestamp);
+            }
+            boost::add_edge(src, dst, Weight(weight, Timestamp(timestamp)), g);
+        }
+
+        int64_t new_degree = boost::out_degree(src, g);
+        edges_added += new_degree - old_degree;
+        if (old_degree == 0 && new_degree > 0) { vertices_added += 1; }
+    }
+    num_edges += edges_added;
+    num_vertices += vertices_added;
+}
+
+void
+shared_dynamic_graph::update_alg(const std::string &alg_name, const std::vector<int64_t> &sources, DynoGraph::Range<int64_t> data) {
+    runAlgorithm(alg_name, g, sources, data);
+}
+
+int64_t
+shared_dynamic_graph::get_out_degree(int64_t vertex_id) const {
+    return boost::out_degree(vertex_id, g);
+}
+
+int64_t
+shared_dynamic_graph::get_num_vertices() const {
+    return num_vertices;
+}
+
+int64_t
+shared_dynamic_graph::get_num_edges() const {
+    return num_edges;
+}
+
+vector<int64_t>
+shared_dynamic_graph::get_high_degree_vertices(int64_t n) const
+{
+    using DynoGraph::vertex_degree;
+    // Get the degree of every vertex with at least one out-edge
+    vector<vertex_degree> degrees;
+    BGL_FORALL_VERTICES_T(v, g, SharedGraph)
+    {
+        int64_t degree = boost::out_degree(v, g);
+        if (degree > 0) { degrees.emplace_back(v, degree); }
+    }
+    // Select the top N, in order of decreasing degree
+    auto middle = degrees.begin() + std::min<ptrdiff_t>(n, degrees.size());
+    std::partial_sort(degrees.begin(), middle, degrees.end(),
+        [](const vertex_degree &a, const vertex_degree &b) { return b < a; });
+    vector<int64_t> vertex_ids(middle - degrees.begin());
+    std::transform(degrees.begin(), middle, vertex_ids.begin(),
+        [](const vertex_degree &a) { return a.vertex_id; }
+    );
+    return vertex_ids;
+}
+
+std::vector<std::string>
+shared_dynamic_graph::get_supported_algs() {
+    return {"bfs", "cc", "gc", "sssp", "pagerank"};
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <dynograph_util/benchmark.h>
+#include "shared_algs.h"
+
+/*
+ * Shared-memory implementation, parallelized with OpenMP within a single process
+ * Each thread updates the out-edges of a disjoint set of source vertices, so no locking is needed
+ */
+class shared_dynamic_graph : public DynoGraph::DynamicGraph
+{
+protected:
+    SharedGraph g;
+    // Number of edges and number of vertices with at least one out-edge
+    int64_t num_edges;
+    int64_t num_vertices;
+public:
+    shared_dynamic_graph(DynoGraph::Args args, int64_t max_vertex_id);
+    shared_dynamic_graph(DynoGraph::Args args, int64_t max_vertex_id, const DynoGraph::Batch & batch);
+
+    virtual void before_batch(const DynoGraph::Batch &batch, int64_t threshold) override;
+    virtual void delete_edges_older_than(int64_t threshold) override;
+    virtual void insert_batch(const DynoGraph::Batch &batch) override;
+    virtual void update_alg(const std::string &alg_name, const std::vector<int64_t> &sources, DynoGraph::Range<int64_t> data) override;
+    virtual int64_t get_out_degree(int64_t vertex_id) const override;
+    virtual int64_t get_num_vertices() const override;
+    virtual int64_t get_num_edges() const override;
+    virtual std::vector<int64_t> get_high_degree_vertices(int64_t n) const override;
+    static std::vector<std::string> get_supported_algs();
+};
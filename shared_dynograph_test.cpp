@@ -0,0 +1,69 @@
+#include "shared_dynamic_graph.h"
+#include <dynograph_util/dynograph_impl_test.h>
+
+INSTANTIATE_TYPED_TEST_CASE_P(SHARED_DYNOGRAPH, ImplTest, shared_dynamic_graph);
+// The shared-memory implementation always runs in a single process, so the whole batch is available
+INSTANTIATE_TYPED_TEST_CASE_P(SHARED_DYNOGRAPH, CompareWithReferenceTest, shared_dynamic_graph);
+
+TEST(SHARED_DYNOGRAPH, TraverseSmallGraph)
+{
+    // 1 -> 2 -> 3, 1 -> 3, 4 -> 5
+    SharedGraph g(6);
+    boost::add_edge(1, 2, Weight(1, Timestamp(1)), g);
+    boost::add_edge(2, 3, Weight(1, Timestamp(1)), g);
+    boost::add_edge(1, 3, Weight(5, Timestamp(1)), g);
+    boost::add_edge(4, 5, Weight(1, Timestamp(1)), g);
+
+    std::vector<int64_t> distance = run_bfs(g, 1);
+    EXPECT_EQ(0, distance[1]);
+    EXPECT_EQ(1, distance[2]);
+    EXPECT_EQ(1, distance[3]);
+    EXPECT_EQ(-1, distance[4]);
+
+    std::vector<int64_t> path_length = run_sssp(g, 1);
+    EXPECT_EQ(2, path_length[3]);
+
+    std::vector<int64_t> component = run_cc(g);
+    EXPECT_EQ(component[1], component[3]);
+    EXPECT_EQ(component[4], component[5]);
+    EXPECT_NE(component[1], component[4]);
+
+    std::vector<int64_t> color = run_gc(g);
+    BGL_FORALL_EDGES_T(e, g, SharedGraph)
+    {
+        EXPECT_NE(color[boost::source(e, g)], color[boost::target(e, g)]);
+    }
+}
+
+// Make sure update_alg writes each algorithm's results into the alg data,
+// in the same form as the distributed implementation
+TEST(SHARED_DYNOGRAPH, WritesAlgData)
+{
+    // 1 -> 2 -> 3, 1 -> 3, 4 -> 5
+    std::vector<DynoGraph::Edge> edges = {{1, 2, 1, 1}, {2, 3, 1, 1}, {1, 3, 5, 1}, {4, 5, 1, 1}};
+    DynoGraph::Args args;
+    args.alg_names = {"bfs", "cc", "gc", "pagerank", "sssp"};
+    shared_dynamic_graph graph(args, 5, DynoGraph::Batch(&*edges.begin(), &*edges.end()));
+    std::vector<int64_t> data(6, 0);
+
+    graph.update_alg("bfs", {1, 4}, data);
+    EXPECT_EQ(std::vector<int64_t>({0, 1, 1, 1, 2, 2}), data);
+
+    graph.update_alg("cc", {}, data);
+    EXPECT_EQ(std::vector<int64_t>({1, 2, 2, 2, 5, 5}), data);
+
+    graph.update_alg("sssp", {1}, data);
+    EXPECT_EQ(std::vector<int64_t>({-1, 0, 1, 2, -1, -1}), data);
+
+    graph.update_alg("gc", {}, data);
+    for (const DynoGraph::Edge& e : edges) { EXPECT_NE(data[e.src], data[e.dst]); }
+
+    graph.update_alg("pagerank", {}, data);
+    SharedGraph g(6);
+    for (const DynoGraph::Edge& e : edges) { boost::add_edge(e.src, e.dst, Weight(e.weight, Timestamp(e.timestamp)), g); }
+    std::vector<double> expected = run_pagerank(g);
+    for (int64_t v = 0; v < 6; ++v)
+    {
+        EXPECT_NEAR(expected[v], DynoGraph::from_fixed_point(data[v], DynoGraph::PAGERANK_FIXED_POINT_SCALE), 1e-12);
+    }
+}
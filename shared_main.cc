@@ -0,0 +1,7 @@
+#include "shared_dynamic_graph.h"
+
+int main(int argc, char *argv[]) {
+    // Run the benchmark
+    DynoGraph::Benchmark::run<shared_dynamic_graph>(argc, argv);
+    return 0;
+}